@@ -0,0 +1,219 @@
+# The benchmarks - each case runs BCFORTH on a script (an example, or one generated in WORK_DIR)
+# and prints its wall time less the time of a run which only starts and ends. The caches are off.
+# Each time is the best of RUNS runs - still, run them on an idle machine.
+#
+# cmake -DBCFORTH=path [ -DCASES=case;case ] [ -DWORK_DIR=dir ] [ -D<case parameter>=... ] -P RunBench.cmake
+# (or just build the bench target)
+#
+# The cases (all by default):
+#	sieve		examples/ErathoSieve.txt, as timed by itself (WORD_PERFORM, ms per run)
+#	lexer		INCLUDE of a file of LEXER_LINES definitions - MB/s of the source (tokenized and compiled)
+#	long_line	a line of LONG_LINE_TOKENS tokens, for each of these numbers - the time per token should stay flat
+#	lookup		1M references compiled into the definitions, on a dictionary of LOOKUP_WORDS words, for each of these numbers
+#	startup		STARTUP_FILES files of STARTUP_LINES definitions given on the command line, with each of STARTUP_JOBS --jobs
+#	memory		DICT-MEMORY - the bytes per word of the dictionary of MEMORY_WORDS words, for each of these numbers
+
+
+if( NOT BCFORTH )
+	message( FATAL_ERROR "usage: cmake -DBCFORTH=path [ -DCASES=case;case ] -P RunBench.cmake" )
+endif()
+
+set( ALL_CASES sieve lexer long_line lookup startup memory )
+
+foreach( param_default
+			"CASES|${ALL_CASES}" "WORK_DIR|${CMAKE_CURRENT_BINARY_DIR}/bench_work" "EXAMPLES|${CMAKE_CURRENT_LIST_DIR}/../examples"
+			"LEXER_LINES|20000" "LONG_LINE_TOKENS|100000;1000000" "LOOKUP_WORDS|1000;100000;1000000"
+			"RUNS|3" "STARTUP_FILES|16" "STARTUP_LINES|2000" "STARTUP_JOBS|1;2;4;8;16" "MEMORY_WORDS|1000;100000" )
+	string( REPLACE "|" ";" param_default "${param_default}" )
+	list( POP_FRONT param_default param )
+	if( NOT DEFINED ${param} )
+		set( ${param} "${param_default}" )
+	endif()
+endforeach()
+
+file( MAKE_DIRECTORY ${WORK_DIR} )
+
+
+
+# Runs BCFORTH RUNS times with the script on its input and the options in ARGN - sets out_us to the best
+# wall time in microseconds and out_text to what it printed. A Forth error stops the benchmarks.
+function( run_forth out_us out_text script )
+	foreach( run RANGE 1 ${RUNS} )
+		string( TIMESTAMP t0 "%s%f" )
+		execute_process( COMMAND ${BCFORTH} --no-cache ${ARGN}
+						INPUT_FILE ${script}
+						OUTPUT_VARIABLE text
+						ERROR_VARIABLE text
+						RESULT_VARIABLE result )
+		string( TIMESTAMP t1 "%s%f" )
+
+		if( NOT result EQUAL 0 OR text MATCHES "Error:" )
+			message( FATAL_ERROR "${script} failed (${result}):\n${text}" )
+		endif()
+
+		math( EXPR us "${t1} - ${t0}" )
+		if( run EQUAL 1 OR us LESS best_us )
+			set( best_us ${us} )
+		endif()
+	endforeach()
+
+	set( ${out_us} ${best_us} PARENT_SCOPE )
+	set( ${out_text} "${text}" PARENT_SCOPE )
+endfunction()
+
+# The time of the run less the start and the end of BCFORTH (at least 1 us)
+function( net_time out_us us )
+	math( EXPR us "${us} - ${START_US}" )
+	if( us LESS 1 )
+		set( us 1 )
+	endif()
+	set( ${out_us} ${us} PARENT_SCOPE )
+endfunction()
+
+# Writes num / den with one decimal digit
+function( ratio out_var num den )
+	math( EXPR x10 "${num} * 10 / ${den}" )
+	math( EXPR int "${x10} / 10" )
+	math( EXPR frac "${x10} % 10" )
+	set( ${out_var} "${int}.${frac}" PARENT_SCOPE )
+endfunction()
+
+function( write_script name text )
+	file( WRITE ${WORK_DIR}/${name} "${text}" )
+endfunction()
+
+# A file of num_lines definitions (a multiple of 1000), each in one line - with a comment and a text, 
+# or empty if ARGN is EMPTY. Their names are <prefix>_<block>_<line>, in each block of 1000 lines from 0 to 999.
+function( write_defs path prefix num_lines )
+	set( block "" )
+	foreach( i RANGE 999 )
+		if( ARGN STREQUAL "EMPTY" )
+			string( APPEND block ": @_${i} ;\n" )
+		else()
+			string( APPEND block ": @_${i} ( a b -- c )  OVER + DUP 2* SWAP - 1000 MOD  S\" the text of @_${i} \" 2DROP ;  \\ word @_${i}\n" )
+		endif()
+	endforeach()
+
+	math( EXPR last_block "${num_lines} / 1000 - 1" )
+	file( WRITE ${path} "" )
+	foreach( k RANGE ${last_block} )
+		string( REPLACE "@" "${prefix}_${k}" text "${block}" )
+		file( APPEND ${path} "${text}" )
+	endforeach()
+endfunction()
+
+
+
+write_script( start.txt "BYE\n" )
+run_forth( START_US text ${WORK_DIR}/start.txt )
+message( "start and end of BCForth: ${START_US} us (subtracted from the times below)" )
+
+
+foreach( bench_case ${CASES} )
+
+	if( bench_case STREQUAL "sieve" )
+		write_script( sieve.txt "INCLUDE ${EXAMPLES}/ErathoSieve.txt\n. CR\nBYE\n" )
+		run_forth( us text ${WORK_DIR}/sieve.txt )
+		string( REGEX MATCH "(^|\n)(-?[0-9]+)[ \t]*\n" ms_per_run "${text}" )
+		string( STRIP "${ms_per_run}" ms_per_run )
+		message( "sieve:      ${ms_per_run} ms per run (N = 2000, 100 runs by WORD_PERFORM)" )
+
+
+	elseif( bench_case STREQUAL "lexer" )
+		# user-027 - the lexer, measured with the compiler behind it
+		write_defs( ${WORK_DIR}/lexer_defs.txt LEX ${LEXER_LINES} )
+		file( SIZE ${WORK_DIR}/lexer_defs.txt bytes )
+		write_script( lexer.txt "INCLUDE ${WORK_DIR}/lexer_defs.txt\nBYE\n" )
+		run_forth( us text ${WORK_DIR}/lexer.txt )
+		net_time( us ${us} )
+		ratio( mb_per_s ${bytes} ${us} )		# bytes per us = MB/s
+		math( EXPR ms "${us} / 1000" )
+		message( "lexer:      ${LEXER_LINES} lines, ${bytes} bytes in ${ms} ms - ${mb_per_s} MB/s" )
+
+
+	elseif( bench_case STREQUAL "long_line" )
+		# user-030 - one line, consumed by the cursor
+		string( REPEAT "1 + " 500 chunk )		# 1000 tokens
+		foreach( num_tokens ${LONG_LINE_TOKENS} )
+			math( EXPR num_chunks "${num_tokens} / 1000" )
+			string( REPEAT "${chunk}" ${num_chunks} line )
+			write_script( long_line.txt "0 ${line}\n. CR\nBYE\n" )
+			run_forth( us text ${WORK_DIR}/long_line.txt )
+			math( EXPR sum "${num_tokens} / 2" )
+			if( NOT text MATCHES "(^|\n)${sum}[ \t]*\n" )
+				message( FATAL_ERROR "long_line: ${sum} expected, got\n${text}" )
+			endif()
+			net_time( us ${us} )
+			math( EXPR ms "${us} / 1000" )
+			ratio( ns_per_token "${us} * 1000" ${num_tokens} )
+			message( "long_line:  ${num_tokens} tokens in ${ms} ms - ${ns_per_token} ns per token" )
+		endforeach()
+
+
+	elseif( bench_case STREQUAL "lookup" )
+		# user-034 - the compiler looks up each name in the symbol tables; the interpreter's token cache is not used
+		foreach( num_words ${LOOKUP_WORDS} )
+			write_defs( ${WORK_DIR}/lookup_defs.txt W ${num_words} EMPTY )
+
+			# 1000 definitions of 1000 references, the k-th one to the words of the block k % ( num_words / 1000 )
+			set( refs "" )
+			foreach( i RANGE 999 )
+				string( APPEND refs " W_@_${i}" )
+			endforeach()
+			math( EXPR num_blocks "${num_words} / 1000" )
+			file( WRITE ${WORK_DIR}/lookup_refs.txt "" )
+			foreach( k RANGE 999 )
+				math( EXPR block "${k} % ${num_blocks}" )
+				string( REPLACE "@" "${block}" line "${refs}" )
+				file( APPEND ${WORK_DIR}/lookup_refs.txt ": REF_${k}${line} ;\n" )
+			endforeach()
+
+			write_script( lookup_base.txt "INCLUDE ${WORK_DIR}/lookup_defs.txt\nBYE\n" )
+			write_script( lookup.txt "INCLUDE ${WORK_DIR}/lookup_defs.txt\nINCLUDE ${WORK_DIR}/lookup_refs.txt\nBYE\n" )
+			run_forth( base_us text ${WORK_DIR}/lookup_base.txt )
+			run_forth( us text ${WORK_DIR}/lookup.txt )
+
+			math( EXPR us "${us} - ${base_us}" )
+			if( us LESS 1 )
+				set( us 1 )
+			endif()
+			ratio( ns_per_lookup "${us} * 1000" 1000000 )
+			message( "lookup:     ${num_words} words - ${ns_per_lookup} ns per compiled reference (1M of them in ${us} us)" )
+		endforeach()
+
+
+	elseif( bench_case STREQUAL "startup" )
+		# user-043 - the files are tokenized on the thread pool, then compiled in their order
+		set( files "" )
+		math( EXPR last_file "${STARTUP_FILES} - 1" )
+		foreach( f RANGE ${last_file} )
+			write_defs( ${WORK_DIR}/startup_${f}.txt S${f} ${STARTUP_LINES} )
+			list( APPEND files ${WORK_DIR}/startup_${f}.txt )
+		endforeach()
+
+		cmake_host_system_information( RESULT num_cores QUERY NUMBER_OF_LOGICAL_CORES )
+		foreach( jobs ${STARTUP_JOBS} )
+			run_forth( us text ${WORK_DIR}/start.txt ${files} --jobs ${jobs} )
+			net_time( us ${us} )
+			math( EXPR ms "${us} / 1000" )
+			message( "startup:    ${STARTUP_FILES} files of ${STARTUP_LINES} lines, --jobs ${jobs}: ${ms} ms (${num_cores} logical cores here)" )
+		endforeach()
+
+
+	elseif( bench_case STREQUAL "memory" )
+		# user-044 - the hot part of the dictionary (the wordlists) and the cold one (the definition log with the comments)
+		foreach( num_words ${MEMORY_WORDS} )
+			write_defs( ${WORK_DIR}/memory_defs.txt M ${num_words} )
+			write_script( memory.txt "INCLUDE ${WORK_DIR}/memory_defs.txt\nDICT-MEMORY\nBYE\n" )
+			run_forth( us text ${WORK_DIR}/memory.txt )
+			string( REGEX MATCHALL "(dictionary memory|sizeof)[^\n]*" report "${text}" )
+			string( REPLACE ";" "\n            " report "${report}" )
+			message( "memory:     ${num_words} words - ${report}" )
+		endforeach()
+
+
+	else()
+		message( FATAL_ERROR "unknown case ${bench_case} - the cases are: ${ALL_CASES}" )
+	endif()
+
+endforeach()
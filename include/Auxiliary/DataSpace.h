@@ -0,0 +1,99 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+
+#pragma once
+
+
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include "StackMemory.h"
+
+
+
+
+namespace BCForth
+{
+
+
+
+	// The data space of the Forth - one contiguous region reserved at once, at the start of which the data
+	// of the CREATEd words go one after another. HERE only moves, so an address once given stays valid.
+	// As for the big stacks, the region lies between the guard pages and the system gives its pages only
+	// when they are touched - so a big reservation costs nothing until used.
+	class TDataSpace
+	{
+		TStackMemoryFor< RawByte >	fMemory;
+
+		size_type		fHere {};			// the used bytes
+
+		size_type		fHighWater {};		// the bytes above it were never used, so they are still 0
+
+	public:
+
+		static constexpr size_type kCellAlign { sizeof( CellType ) };
+
+		explicit TDataSpace( const size_type bytes ) : fMemory( bytes, true ) {}
+
+	public:
+
+		RawByte *	Begin( void ) const { return fMemory.get(); }
+
+		RawByte *	Here( void ) const { return fMemory.get() + fHere; }
+
+		size_type	Used( void ) const { return fHere; }
+
+		size_type	Unused( void ) const { return fMemory.capacity() - fHere; }
+
+		bool		Contains( const RawByte * p ) const { return p >= Begin() && p < Here(); }
+
+		// The n bytes at HERE, which are 0 (as were the new data of CREATE)
+		RawByte * Allot( const size_type n )
+		{
+			if( n > Unused() )
+				throw ForthError( "data space overflow (" + std::to_string( Unused() ) + " bytes unused)" );
+
+			const auto p { Here() };
+			if( fHere < fHighWater )
+				std::memset( p, 0, std::min( n, fHighWater - fHere ) );
+
+			fHere += n;
+			fHighWater = std::max( fHighWater, fHere );
+			return p;
+		}
+
+		// The bytes to HERE aligned to a cell (the region begins at a page)
+		size_type	Padding( void ) const { return ( kCellAlign - fHere % kCellAlign ) % kCellAlign; }
+
+		// Gives back the last n bytes
+		void Free( const size_type n )
+		{
+			assert( n <= fHere );
+			fHere -= n;
+		}
+
+		// Moves HERE back to what Used() was (FORGET, MARKER)
+		void Rewind( const size_type used )
+		{
+			fHere = std::min( fHere, used );
+		}
+
+	};
+
+
+
+
+}	// The end of the BCForth namespace
+
+
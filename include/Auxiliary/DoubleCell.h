@@ -0,0 +1,195 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+
+#pragma once
+
+
+
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+
+
+namespace BCForth
+{
+
+
+
+	// The arithmetic of the double-cell numbers, each kept in two cells of type U - the less significant one (lo)
+	// and the more significant one (hi), which holds the sign. The products and the quotients go through a type
+	// twice as wide as the cell, if there is one (__int128 for the 64-bit cells) - otherwise the halves of the cells are used.
+	template < typename U >
+	struct TDoubleCellFor
+	{
+		static_assert( std::is_unsigned_v< U > );
+
+		using S = std::make_signed_t< U >;
+
+		using Pair = std::pair< U, U >;
+
+		static constexpr int	kBits		{ 8 * sizeof( U ) };
+		static constexpr U		kSignBit	{ U( 1 ) << ( kBits - 1 ) };
+
+		static constexpr bool	IsNeg( const U hi ) { return ( hi & kSignBit ) != 0; }
+
+		// The sign extension of a single cell
+		static constexpr Pair	FromCell( const U x ) { return { x, IsNeg( x ) ? ~ U( 0 ) : U( 0 ) }; }
+
+		static constexpr Pair	Negate( const U lo, const U hi ) { return { U( 0 ) - lo, ~ hi + ( lo == 0 ) }; }
+
+		static constexpr Pair	Plus( const U a_lo, const U a_hi, const U b_lo, const U b_hi )
+		{
+			const U lo { a_lo + b_lo };
+			return { lo, a_hi + b_hi + ( lo < a_lo ) };
+		}
+
+		static constexpr Pair	Minus( const U a_lo, const U a_hi, const U b_lo, const U b_hi )
+		{
+			return { a_lo - b_lo, a_hi - b_hi - ( a_lo < b_lo ) };
+		}
+
+		static constexpr bool	Less( const U a_lo, const U a_hi, const U b_lo, const U b_hi )
+		{
+			return a_hi != b_hi ? static_cast< S >( a_hi ) < static_cast< S >( b_hi ) : a_lo < b_lo;
+		}
+
+
+		// ( lo, hi ) of a * b
+		static constexpr Pair Mul( const U a, const U b )
+		{
+			if constexpr( sizeof( U ) <= sizeof( std::uint32_t ) )
+			{
+				const auto p { std::uint64_t( a ) * b };
+				return { U( p ), U( p >> kBits ) };
+			}
+#if defined( __SIZEOF_INT128__ ) && ! defined( BCFORTH_NO_INT128 )
+			else if constexpr( sizeof( U ) == sizeof( std::uint64_t ) )
+			{
+				const auto p { static_cast< unsigned __int128 >( a ) * b };
+				return { U( p ), U( p >> kBits ) };
+			}
+#endif
+			else
+			{
+				constexpr int kHalf { kBits / 2 };
+				constexpr U kMask { ( U( 1 ) << kHalf ) - 1 };
+
+				const U a0 { a & kMask }, a1 { a >> kHalf }, b0 { b & kMask }, b1 { b >> kHalf };
+				const U p00 { a0 * b0 }, p01 { a0 * b1 }, p10 { a1 * b0 }, p11 { a1 * b1 };
+
+				const U mid { ( p00 >> kHalf ) + ( p01 & kMask ) + ( p10 & kMask ) };		// cannot overflow
+				return { ( p00 & kMask ) | ( mid << kHalf ), p11 + ( p01 >> kHalf ) + ( p10 >> kHalf ) + ( mid >> kHalf ) };
+			}
+		}
+
+		// ( quotient, remainder ) of ( lo, hi ) / d, if hi < d (then the quotient fits in a cell)
+		static constexpr Pair Div( const U lo, const U hi, const U d )
+		{
+			if constexpr( sizeof( U ) <= sizeof( std::uint32_t ) )
+			{
+				const auto n { std::uint64_t( hi ) << kBits | lo };
+				return { U( n / d ), U( n % d ) };
+			}
+#if defined( __SIZEOF_INT128__ ) && ! defined( BCFORTH_NO_INT128 )
+			else if constexpr( sizeof( U ) == sizeof( std::uint64_t ) )
+			{
+				const auto n { static_cast< unsigned __int128 >( hi ) << kBits | lo };
+				return { U( n / d ), U( n % d ) };
+			}
+#endif
+			else
+			{
+				// Bit by bit - the remainder is always less than d
+				U q {}, r { hi };
+				for( int i { kBits }; i -- > 0; )
+				{
+					const bool carry { IsNeg( r ) };
+					r = r << 1 | ( lo >> i & 1 );
+					q <<= 1;
+					if( carry || r >= d )
+						r -= d, q |= 1;
+				}
+				return { q, r };
+			}
+		}
+
+
+		// The signed ( lo, hi ) of a * b
+		static constexpr Pair SignedMul( const U a, const U b )
+		{
+			const auto [ lo, hi ] { Mul( a, b ) };
+			// As unsigned, each negative factor added 2^kBits times the other one to the product
+			return { lo, hi - ( IsNeg( a ) ? b : 0 ) - ( IsNeg( b ) ? a : 0 ) };
+		}
+
+		// The symmetric ( quotient, remainder ) of the signed ( lo, hi ) / d - nothing if d is 0, or the quotient does not fit in a cell
+		static constexpr std::optional< Pair > SignedDiv( U lo, U hi, const U d )
+		{
+			const bool neg_n { IsNeg( hi ) }, neg_d { IsNeg( d ) };
+
+			if( neg_n )
+				std::tie( lo, hi ) = Negate( lo, hi );
+
+			const U abs_d { neg_d ? U( 0 ) - d : d };
+			if( hi >= abs_d )
+				return {};
+
+			const auto [ q, r ] { Div( lo, hi, abs_d ) };
+			if( neg_n != neg_d ? q > kSignBit : q >= kSignBit )
+				return {};
+
+			return Pair { neg_n != neg_d ? U( 0 ) - q : q, neg_n ? U( 0 ) - r : r };
+		}
+
+		// The signed ( lo, hi ) * n / d, rounded toward 0, with a triple-cell product - nothing if d is 0, or the result
+		// does not fit in a double cell
+		static constexpr std::optional< Pair > SignedMulDiv( U lo, U hi, U n, U d )
+		{
+			const bool neg_quot { ( IsNeg( hi ) != IsNeg( n ) ) != IsNeg( d ) };		// the sign of the quotient - XOR of the three signs
+
+			if( IsNeg( hi ) )
+				std::tie( lo, hi ) = Negate( lo, hi );
+			if( IsNeg( n ) )
+				n = U( 0 ) - n;
+			if( IsNeg( d ) )
+				d = U( 0 ) - d;
+
+			if( d == 0 )
+				return {};
+
+			// t2 t1 t0 = ( hi lo ) * n
+			const auto [ p0, p1 ] { Mul( lo, n ) };
+			const auto [ q0, q1 ] { Mul( hi, n ) };
+			const U t0 { p0 }, t1 { p1 + q0 }, t2 { q1 + ( t1 < p1 ) };
+
+			if( t2 >= d )
+				return {};
+
+			const auto [ r_hi, r1 ] { Div( t1, t2, d ) };
+			const auto [ r_lo, r0 ] { Div( t0, r1, d ) };
+
+			if( IsNeg( r_hi ) && ! ( neg_quot && r_hi == kSignBit && r_lo == 0 ) )
+				return {};
+
+			return neg_quot ? Negate( r_lo, r_hi ) : Pair { r_lo, r_hi };
+		}
+	};
+
+
+
+
+}	// The end of the BCForth namespace
+
+
@@ -0,0 +1,190 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+
+#pragma once
+
+
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+#include "BaseDefinitions.h"
+
+
+
+
+namespace BCForth
+{
+
+
+
+	// A bump allocator for the word nodes. The nodes are placed one after another in the order
+	// of their creation, so the nodes of one definition (and their vectors) lie close to each other.
+	// The memory is released all at once by Rewind, which takes the time proportional to the number
+	// of the released chunks. A block returned before (e.g. the old buffer of a grown vector, or a node
+	// of a reclaimed garbage word) goes to the free list of its size, from which it is given again.
+	class TNodeArena : public std::pmr::memory_resource
+	{
+	public:
+
+		static constexpr size_type kFirstChunkBytes { 64 * 1024 };
+		static constexpr size_type kMaxChunkBytes { 1024 * 1024 };
+
+		// The position of the arena, to which it can be rewound
+		struct Mark
+		{
+			size_type	fChunk {};			// the number of the chunks in use
+			size_type	fOffset {};			// the used bytes of the last one
+			size_type	fAllocs {};
+		};
+
+	private:
+
+		struct Chunk
+		{
+			std::unique_ptr< std::byte [] >	fData;
+			size_type						fSize {};
+		};
+
+		std::vector< Chunk >	fChunks;
+
+		size_type				fOffset {};			// the first free byte of the last chunk
+
+		size_type				fNumAllocs {};
+
+		std::unordered_map< size_type, std::vector< std::byte * > >		fFreeLists;		// the size -> the returned blocks
+
+		size_type				fFreeBytes {};
+
+	private:
+
+		void * do_allocate( std::size_t bytes, std::size_t alignment ) override
+		{
+			if( fFreeBytes > 0 )
+				if( const auto pos { fFreeLists.find( bytes ) }; pos != fFreeLists.end() )
+				{
+					auto & blocks { pos->second };
+					for( auto i { blocks.size() }; i -- > 0; )
+						if( reinterpret_cast< std::uintptr_t >( blocks[ i ] ) % alignment == 0 )
+						{
+							const auto p { blocks[ i ] };
+							blocks.erase( blocks.begin() + i );
+							fFreeBytes -= bytes;
+							return p;
+						}
+				}
+
+			if( fChunks.size() > 0 )
+			{
+				auto & chunk { fChunks.back() };
+				const auto base { reinterpret_cast< std::uintptr_t >( chunk.fData.get() ) };
+				const auto pos { ( ( base + fOffset + alignment - 1 ) & ~( alignment - 1 ) ) - base };
+				if( pos + bytes <= chunk.fSize )
+				{
+					fOffset = pos + bytes;
+					++ fNumAllocs;
+					return chunk.fData.get() + pos;
+				}
+			}
+
+			// The chunks grow up to kMaxChunkBytes, a bigger object gets its own one
+			const auto chunk_size { std::max< size_type >( bytes + alignment, fChunks.size() == 0 ? kFirstChunkBytes : std::min( 2 * fChunks.back().fSize, kMaxChunkBytes ) ) };
+			fChunks.push_back( { std::make_unique< std::byte [] >( chunk_size ), chunk_size } );
+			fOffset = 0;
+
+			return do_allocate( bytes, alignment );
+		}
+
+		// The memory goes back with Rewind, or to a free list
+		void do_deallocate( void * p, std::size_t bytes, std::size_t ) override
+		{
+			if( p != nullptr && bytes > 0 )
+			{
+				fFreeLists[ bytes ].push_back( static_cast< std::byte * >( p ) );
+				fFreeBytes += bytes;
+			}
+		}
+
+		bool do_is_equal( const std::pmr::memory_resource & other ) const noexcept override { return this == & other; }
+
+	public:
+
+		Mark GetMark( void ) const { return { fChunks.size(), fOffset, fNumAllocs }; }
+
+		// Releases everything allocated after the mark - the objects there should be already destroyed
+		void Rewind( const Mark & mark )
+		{
+			assert( mark.fChunk <= fChunks.size() );
+			if( mark.fChunk < fChunks.size() )
+				fChunks.erase( fChunks.begin() + std::max< size_type >( mark.fChunk, 1 ), fChunks.end() );
+
+			fOffset		= mark.fChunk == 0 ? 0 : mark.fOffset;
+			fNumAllocs	= mark.fAllocs;
+
+			// The free blocks above the mark are gone
+			if( fFreeBytes > 0 )
+				for( auto & [ bytes, blocks ] : fFreeLists )
+					std::erase_if( blocks, [ &, bytes = bytes ] ( const std::byte * p )
+					{
+						if( IsBelowTop( p ) )
+							return false;
+						fFreeBytes -= bytes;
+						return true;
+					} );
+		}
+
+		// True if the block lies in the used part of the arena
+		bool IsBelowTop( const std::byte * p ) const
+		{
+			for( size_type i {}; i < fChunks.size(); ++ i )
+				if( const auto data { fChunks[ i ].fData.get() }; p >= data && p < data + ( i + 1 < fChunks.size() ? fChunks[ i ].fSize : fOffset ) )
+					return true;
+			return false;
+		}
+
+	public:
+
+		size_type	GetNumOfAllocs( void ) const { return fNumAllocs; }
+
+		size_type	GetNumOfChunks( void ) const { return fChunks.size(); }
+
+		size_type	GetFreeBytes( void ) const { return fFreeBytes; }
+
+		size_type	GetReservedBytes( void ) const
+		{
+			size_type bytes {};
+			for( const auto & c : fChunks )
+				bytes += c.fSize;
+			return bytes;
+		}
+
+		size_type	GetUsedBytes( void ) const
+		{
+			size_type bytes { fOffset };
+			for( size_type i {}; i + 1 < fChunks.size(); ++ i )
+				bytes += fChunks[ i ].fSize;		// the tails of the previous chunks are counted as used
+			return bytes;
+		}
+
+	};
+
+
+
+
+}	// The end of the BCForth namespace
+
+
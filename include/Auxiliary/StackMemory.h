@@ -0,0 +1,267 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+
+#pragma once
+
+
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+	#include <csignal>
+	#include <sys/mman.h>
+	#include <unistd.h>
+	#define BCFORTH_STACK_GUARD_PAGES
+#endif
+
+#include "BaseDefinitions.h"
+
+
+
+
+namespace BCForth
+{
+
+
+
+#ifdef BCFORTH_STACK_GUARD_PAGES
+	inline constexpr bool kHasStackGuardPages { true };
+#else
+	inline constexpr bool kHasStackGuardPages { false };
+#endif
+
+
+
+	// The guard pages of all stacks, so a fault in one of them can be told from other faults.
+	// It is read by the signal handler, so it is a fixed array of atomics rather than a container.
+	class TStackGuards
+	{
+		static constexpr size_type kMaxGuards { 64 };
+
+		struct Guard
+		{
+			std::atomic< std::uintptr_t >	fBegin;
+			std::atomic< std::uintptr_t >	fEnd;
+		};
+
+		static inline std::array< Guard, kMaxGuards >	fGuards;
+
+		static inline std::atomic< bool >	fHandlerInstalled { false };
+
+#ifdef BCFORTH_STACK_GUARD_PAGES
+		static inline struct sigaction		fPrevAction {};
+
+		static void OnFault( int sig, siginfo_t * info, void * context )
+		{
+			if( Contains( reinterpret_cast< std::uintptr_t >( info->si_addr ) ) )
+			{
+				// Nothing can be unwound from here - the program ends
+				static constexpr char kMsg[] { "\nError: stack overflow or underflow (a stack guard page was hit)\n" };
+				[[ maybe_unused ]] const auto r { write( STDERR_FILENO, kMsg, sizeof( kMsg ) - 1 ) };
+				_exit( EXIT_FAILURE );
+			}
+
+			// Not ours - it goes to the previous handler, while ours stays installed for the next faults
+			if( ( fPrevAction.sa_flags & SA_SIGINFO ) != 0 && fPrevAction.sa_sigaction != nullptr )
+			{
+				fPrevAction.sa_sigaction( sig, info, context );
+			}
+			else if( fPrevAction.sa_handler != SIG_DFL && fPrevAction.sa_handler != SIG_IGN )
+			{
+				fPrevAction.sa_handler( sig );
+			}
+			else
+			{
+				// The default action (a fault cannot be ignored) - delivered as soon as this handler returns
+				signal( sig, SIG_DFL );
+				raise( sig );
+			}
+		}
+#endif
+
+		static bool Contains( const std::uintptr_t addr )
+		{
+			for( const auto & g : fGuards )
+				if( addr >= g.fBegin.load( std::memory_order_relaxed ) && addr < g.fEnd.load( std::memory_order_relaxed ) )
+					return true;
+			return false;
+		}
+
+	public:
+
+		// Returns false if all kMaxGuards slots are taken - such a guard page would not be told from other faults
+		[[ nodiscard ]] static bool Add( const void * begin, const size_type bytes )
+		{
+			InstallHandler();
+
+			for( auto & g : fGuards )
+				if( std::uintptr_t expected {}; g.fEnd.load() == 0 && g.fBegin.compare_exchange_strong( expected, reinterpret_cast< std::uintptr_t >( begin ) ) )
+				{
+					g.fEnd = reinterpret_cast< std::uintptr_t >( begin ) + bytes;
+					return true;
+				}
+			return false;
+		}
+
+		static void Remove( const void * begin )
+		{
+			for( auto & g : fGuards )
+				if( g.fBegin.load() == reinterpret_cast< std::uintptr_t >( begin ) )
+				{
+					g.fEnd = 0;
+					g.fBegin = 0;
+					return;
+				}
+		}
+
+	private:
+
+		static void InstallHandler( void )
+		{
+#ifdef BCFORTH_STACK_GUARD_PAGES
+			if( fHandlerInstalled.exchange( true ) )
+				return;
+
+			struct sigaction action {};
+			action.sa_sigaction = & OnFault;
+			action.sa_flags = SA_SIGINFO;
+			sigemptyset( & action.sa_mask );
+			sigaction( SIGSEGV, & action, & fPrevAction );
+#endif
+		}
+	};
+
+
+
+	// The memory of a stack. A guarded one is reserved with mmap between two inaccessible pages, so running
+	// off either end of the stack is caught by the MMU rather than by a compare in each operation. Its size
+	// is rounded up to whole pages, which the system gives only when touched - so a stack of millions
+	// of cells costs nothing until used. The others (and all if there is no mmap) go on the heap.
+	template < typename T >
+	class TStackMemoryFor
+	{
+		T *			fData {};
+		size_type	fCapacity {};
+
+		std::unique_ptr< T [] >		fHeapData;
+
+		std::byte *	fMapping {};		// with the guard pages
+		size_type	fMappingBytes {};
+
+	public:
+
+		// Only the trivial elements can live in the raw pages
+		static constexpr bool kCanBeGuarded { kHasStackGuardPages && std::is_trivial_v< T > };
+
+		TStackMemoryFor( const size_type num_elems, const bool guarded )
+		{
+			if constexpr( kCanBeGuarded )
+				if( guarded )
+				{
+					MapGuarded( num_elems );
+					return;
+				}
+
+			fHeapData = std::make_unique< T [] >( num_elems );
+			fData = fHeapData.get();
+			fCapacity = num_elems;
+		}
+
+		~TStackMemoryFor() { Unmap(); }
+
+		TStackMemoryFor( TStackMemoryFor && other ) noexcept { * this = std::move( other ); }
+
+		TStackMemoryFor & operator = ( TStackMemoryFor && other ) noexcept
+		{
+			if( this != & other )
+			{
+				Unmap();
+				fData			= std::exchange( other.fData, nullptr );
+				fCapacity		= std::exchange( other.fCapacity, 0 );
+				fHeapData		= std::move( other.fHeapData );
+				fMapping		= std::exchange( other.fMapping, nullptr );
+				fMappingBytes	= std::exchange( other.fMappingBytes, 0 );
+			}
+			return * this;
+		}
+
+	public:
+
+		T *			get( void ) const { return fData; }
+
+		// Can be more than asked for, if guarded
+		size_type	capacity( void ) const { return fCapacity; }
+
+		bool		IsGuarded( void ) const { return fMapping != nullptr; }
+
+	private:
+
+		void MapGuarded( const size_type num_elems )
+		{
+#ifdef BCFORTH_STACK_GUARD_PAGES
+			const auto kPage { static_cast< size_type >( sysconf( _SC_PAGESIZE ) ) };
+			const auto kDataBytes { std::max< size_type >( ( num_elems * sizeof( T ) + kPage - 1 ) / kPage * kPage, kPage ) };
+
+			fMappingBytes = kDataBytes + 2 * kPage;
+			const auto p { mmap( nullptr, fMappingBytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 ) };
+			if( p == MAP_FAILED )
+				throw ForthError( "cannot reserve a stack of " + std::to_string( num_elems ) + " cells" );
+
+			fMapping = static_cast< std::byte * >( p );
+			if( mprotect( fMapping + kPage, kDataBytes, PROT_READ | PROT_WRITE ) != 0 )
+			{
+				munmap( fMapping, fMappingBytes );
+				fMapping = nullptr;
+				throw ForthError( "cannot reserve a stack of " + std::to_string( num_elems ) + " cells" );
+			}
+
+			if( ! TStackGuards::Add( fMapping, kPage ) || ! TStackGuards::Add( fMapping + kPage + kDataBytes, kPage ) )
+			{
+				TStackGuards::Remove( fMapping );
+				munmap( fMapping, fMappingBytes );
+				fMapping = nullptr;
+				throw ForthError( "too many guarded stacks - no room for the guard pages of a stack of " + std::to_string( num_elems ) + " cells" );
+			}
+
+			fData = reinterpret_cast< T * >( fMapping + kPage );
+			fCapacity = kDataBytes / sizeof( T );
+#endif
+		}
+
+		void Unmap( void )
+		{
+#ifdef BCFORTH_STACK_GUARD_PAGES
+			if( fMapping != nullptr )
+			{
+				const auto kPage { static_cast< size_type >( sysconf( _SC_PAGESIZE ) ) };
+				TStackGuards::Remove( fMapping );
+				TStackGuards::Remove( fMapping + fMappingBytes - kPage );
+				munmap( fMapping, fMappingBytes );
+				fMapping = nullptr;
+			}
+#endif
+		}
+
+	};
+
+
+
+
+}	// The end of the BCForth namespace
+
+
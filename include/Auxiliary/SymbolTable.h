@@ -0,0 +1,286 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+
+#pragma once
+
+
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <utility>
+
+#include "BaseDefinitions.h"
+
+
+
+
+namespace BCForth
+{
+
+
+
+	// Each name is interned once and receives a 32-bit ID; the IDs are consecutive and never reused.
+	// The lookup goes with std::string_view, so no string is built. The table is an open addressing
+	// one (linear probing, at most half full), which keeps the probes short also for 100k+ names.
+	// The names are compared as they are - the case is folded by the tokenizer, as before.
+	class TSymbolTable
+	{
+	public:
+
+		using SymbolID = std::uint32_t;
+
+		static constexpr SymbolID kNoSymbol { ~SymbolID() };
+
+	private:
+
+		// A slot keeps the hash next to the ID, so the probing does not touch the names
+		struct Slot
+		{
+			std::uint32_t	fHash {};
+			SymbolID		fID { kNoSymbol };		// kNoSymbol marks a free slot
+		};
+
+		std::vector< Name >				fNames;				// ID -> name
+		std::vector< Slot >				fSlots;				// the hash table
+
+		static constexpr size_type		kInitSlots { 1024 };	// always a power of 2
+
+	private:
+
+		static std::uint32_t Hash( const std::string_view n )
+		{
+			return static_cast< std::uint32_t >( std::hash< std::string_view >{}( n ) );
+		}
+
+		// Returns the slot which holds the name, or the free one where it should go
+		size_type FindSlot( const std::string_view n, const std::uint32_t h ) const
+		{
+			const auto kMask { fSlots.size() - 1 };
+			for( auto i { h & kMask }; ; i = ( i + 1 ) & kMask )
+				if( const auto & slot { fSlots[ i ] }; slot.fID == kNoSymbol || ( slot.fHash == h && fNames[ slot.fID ] == n ) )
+					return i;
+		}
+
+		// The names are re-entered in the order of their IDs - then the probing path of each name goes only
+		// through the slots of the older names, so the newest name can be removed just by freeing its slot
+		void Grow( void )
+		{
+			std::vector< Slot > by_id( fNames.size() );
+			for( const auto & slot : fSlots )
+				if( slot.fID != kNoSymbol )
+					by_id[ slot.fID ] = slot;
+
+			fSlots.assign( fSlots.size() == 0 ? kInitSlots : 2 * fSlots.size(), Slot() );
+
+			const auto kMask { fSlots.size() - 1 };
+			for( const auto & slot : by_id )
+			{
+				auto i { slot.fHash & kMask };
+				while( fSlots[ i ].fID != kNoSymbol )
+					i = ( i + 1 ) & kMask;
+				fSlots[ i ] = slot;
+			}
+		}
+
+	public:
+
+		// Returns kNoSymbol if the name has not been interned
+		SymbolID Find( const std::string_view n ) const
+		{
+			return fSlots.size() == 0 ? kNoSymbol : fSlots[ FindSlot( n, Hash( n ) ) ].fID;
+		}
+
+		// Returns the ID of the name, a new one if the name is seen for the first time
+		SymbolID Intern( const std::string_view n )
+		{
+			if( 2 * ( fNames.size() + 1 ) > fSlots.size() )
+				Grow();
+
+			const auto h { Hash( n ) };
+			auto & slot { fSlots[ FindSlot( n, h ) ] };
+			if( slot.fID == kNoSymbol )
+			{
+				assert( fNames.size() < kNoSymbol );
+				slot = { h, static_cast< SymbolID >( fNames.size() ) };
+				fNames.emplace_back( n );
+			}
+
+			return slot.fID;
+		}
+
+		// Removes the most recently interned name
+		void PopBack( void )
+		{
+			assert( fNames.size() > 0 );
+			const auto & n { fNames.back() };
+			fSlots[ FindSlot( n, Hash( n ) ) ] = Slot();
+			fNames.pop_back();
+		}
+
+		const Name &	GetName( const SymbolID id ) const { assert( id < fNames.size() ); return fNames[ id ]; }
+
+		size_type		size( void ) const { return fNames.size(); }
+
+		// The bytes of the table and of the names (with their parts on the heap)
+		size_type GetNumOfBytes( void ) const
+		{
+			size_type bytes { fNames.capacity() * sizeof( Name ) + fSlots.capacity() * sizeof( Slot ) };
+			for( const auto & n : fNames )
+				if( n.capacity() > Name().capacity() )		// not in the string itself
+					bytes += n.capacity() + 1;
+			return bytes;
+		}
+
+	};
+
+
+
+
+	// Maps the interned names to values. A value entered for a name which is already there
+	// does not replace the old one, but it shadows it - the old one becomes visible again when
+	// the new one is removed. The values are removed in the reverse order of their insertion.
+	// Once entered, a value does not change its address until it is removed.
+	// A shadowed value can be unlinked - then it is never visible again, but it stays in its place.
+	template < typename V >
+	class TSymbolMapFor
+	{
+	public:
+
+		using SymbolTable	= TSymbolTable;
+		using SymbolID		= typename SymbolTable::SymbolID;
+
+	private:
+
+		static constexpr size_type kNoEntry { ~size_type() };
+		static constexpr size_type kUnlinked { kNoEntry - 1 };
+
+		struct Entry
+		{
+			V			fValue;
+			SymbolID	fID {};
+			size_type	fShadowed { kNoEntry };		// the previous entry with the same name, or kUnlinked
+		};
+
+		SymbolTable						fSymbols;
+		std::deque< Entry >				fEntries;		// in the order of insertion
+		std::vector< size_type >		fHeads;			// ID -> the newest entry of that name, or kNoEntry
+		std::vector< size_type >		fNumEntries;	// ID -> the number of the entries of that name (also the unlinked ones)
+
+	public:
+
+		// Returns nullptr if there is no value for the name
+		V * find( const std::string_view n )
+		{
+			const auto id { fSymbols.Find( n ) };
+			return id < fHeads.size() && fHeads[ id ] != kNoEntry ? & fEntries[ fHeads[ id ] ].fValue : nullptr;
+		}
+
+		// Enters a new value for the name, shadowing the previous one (if any)
+		V & Insert( const std::string_view n, V && v )
+		{
+			const auto id { fSymbols.Intern( n ) };
+			if( id >= fHeads.size() )
+				fHeads.resize( id + 1, kNoEntry ), fNumEntries.resize( id + 1 );
+
+			fEntries.push_back( Entry { std::move( v ), id, fHeads[ id ] } );
+			fHeads[ id ] = fEntries.size() - 1;
+			++ fNumEntries[ id ];
+
+			return fEntries.back().fValue;
+		}
+
+		// Removes the most recently inserted value, and its name if it is not used anymore
+		void PopBack( void )
+		{
+			assert( fEntries.size() > 0 );
+			const auto & e { fEntries.back() };
+			if( e.fShadowed != kUnlinked )
+				fHeads[ e.fID ] = e.fShadowed;
+			-- fNumEntries[ e.fID ];
+			fEntries.pop_back();
+
+			while( fNumEntries.size() > 0 && fNumEntries.back() == 0 )
+			{
+				fHeads.pop_back();
+				fNumEntries.pop_back();
+				fSymbols.PopBack();
+			}
+		}
+
+		// Takes the value out of the chain of its name, so it cannot be found, nor is it visible again
+		// when the ones which shadow it are removed. Returns false if there is no such value for the name.
+		bool Unlink( const std::string_view n, const V * v )
+		{
+			const auto id { fSymbols.Find( n ) };
+			if( id >= fHeads.size() )
+				return false;
+
+			for( auto * link { & fHeads[ id ] }; * link != kNoEntry; link = & fEntries[ * link ].fShadowed )
+				if( auto & e { fEntries[ * link ] }; & e.fValue == v )
+				{
+					* link = std::exchange( e.fShadowed, kUnlinked );
+					return true;
+				}
+
+			return false;
+		}
+
+		// The number of values, including the shadowed ones
+		size_type size( void ) const { return fEntries.size(); }
+
+		const SymbolTable & GetSymbols( void ) const { return fSymbols; }
+
+		// The bytes of the entries and of the symbols (not of what the values own)
+		size_type GetNumOfBytes( void ) const
+		{
+			return fSymbols.GetNumOfBytes() + fEntries.size() * sizeof( Entry ) + ( fHeads.capacity() + fNumEntries.capacity() ) * sizeof( size_type );
+		}
+
+	public:
+
+		// Goes over the ( name, value ) pairs in the order of the insertion, including the shadowed ones
+		template < typename MapPtr, typename Val >
+		class TIterator
+		{
+			MapPtr		fMap {};
+			size_type	fPos {};
+
+		public:
+
+			TIterator( MapPtr m, size_type pos ) : fMap( m ), fPos( pos ) {}
+
+			std::pair< const Name &, Val & > operator * ( void ) const { auto & e { fMap->fEntries[ fPos ] }; return { fMap->fSymbols.GetName( e.fID ), e.fValue }; }
+
+			TIterator & operator ++ ( void ) { ++ fPos; return * this; }
+
+			bool operator == ( const TIterator & it ) const { return fPos == it.fPos; }
+		};
+
+		using iterator			= TIterator< TSymbolMapFor *, V >;
+		using const_iterator	= TIterator< const TSymbolMapFor *, const V >;
+
+		iterator		begin( void )		{ return iterator( this, 0 ); }
+		iterator		end( void )			{ return iterator( this, fEntries.size() ); }
+
+		const_iterator	begin( void ) const	{ return const_iterator( this, 0 ); }
+		const_iterator	end( void ) const	{ return const_iterator( this, fEntries.size() ); }
+
+	};
+
+
+
+
+}	// The end of the BCForth namespace
+
@@ -16,6 +16,11 @@
 
 
 #include <cassert>
+#include <memory>
+#include <tuple>
+
+#include "StackMemory.h"
+#include "DoubleCell.h"
 
 
 
@@ -26,47 +31,82 @@ namespace BCForth
 
 	// ==============================================================================================
 
-	// Definition of the base stack data structure
-	template < typename T, auto MaxElems >
+	// Definition of the base stack data structure. Its capacity is given at the construction (MaxElems by default).
+	// If not Checked, then the operations do not check the number of the elements - the stack lies between
+	// the guard pages (see TStackMemoryFor), so running off its ends is caught by the MMU.
+	template < typename T, auto MaxElems, bool Checked = true >
 	class TStackFor
 	{
 	public:
 
 		using value_type = T;
-		enum { kMaxSize = MaxElems };
+		enum { kMaxSize = MaxElems };		// the default capacity
+
+		static constexpr bool kChecked { Checked };
 
 		// Here we need an additional typename
 		using size_type = BCForth::size_type;
 
+		// A bigger stack goes between the guard pages also if checked
+		static constexpr size_type kGuardedBytes { 64 * 1024 };
+
 	protected:
 
 		size_type							fStackPtr {};		// indicates the first free cell
 
-		std::unique_ptr< value_type [] >	fData;
+		TStackMemoryFor< value_type >		fMemory;
+
+		value_type *						fData {};
 
+		size_type							fMaxSize {};
+
+		// True if there are at least n elements (always if not checked)
+		constexpr bool Has( const size_type n ) const
+		{
+			if constexpr( Checked )
+				return fStackPtr >= n;
+			else
+				return true;
+		}
 
+		// True if one more element fits
+		constexpr bool HasRoom( void ) const
+		{
+			if constexpr( Checked )
+				return fStackPtr < fMaxSize;
+			else
+				return true;
+		}
 
 	public:
 
 		constexpr size_type size() const { return fStackPtr; }
 
+		constexpr size_type max_size() const { return fMaxSize; }
 
-		constexpr T * data() const { return fData.get(); }
+		constexpr T * data() const { return fData; }
+
+		// True if the stack lies between the guard pages
+		bool IsGuarded() const { return fMemory.IsGuarded(); }
 
 
 		constexpr void clear() { fStackPtr = 0; }
 
+		// Cuts the stack down to new_size elements (e.g. to drop a whole frame at once)
+		constexpr bool Truncate( size_type new_size ) { return new_size <= fStackPtr ? fStackPtr = new_size, true : false; }
+
 	public:
 
-		constexpr TStackFor()
-			: fStackPtr( 0 )
+		explicit TStackFor( const size_type max_size = kMaxSize )
+			: fStackPtr( 0 ), fMemory( max_size, ! Checked || max_size * sizeof( value_type ) >= kGuardedBytes ), fData( fMemory.get() ), 
+				fMaxSize( Checked ? max_size : fMemory.capacity() )
 		{
-			fData = std::make_unique< value_type [] >( kMaxSize );
+			static_assert( Checked || TStackMemoryFor< value_type >::kCanBeGuarded, "an unchecked stack needs the guard pages" );
 		}
 
 
 		// We don't need to explicitly disable copying (i.e. the assignment and the copy constructor), 
-		// since std::unique_ptr will force that this class can be moved but not copied
+		// since TStackMemoryFor will force that this class can be moved but not copied
 
 	public:
 
@@ -92,13 +132,13 @@ namespace BCForth
 		//		
 		constexpr bool Push( const value_type & new_elem )
 		{
-			return fStackPtr < kMaxSize ? fData[ fStackPtr ++ ] = new_elem, true : false;
+			return HasRoom() ? fData[ fStackPtr ++ ] = new_elem, true : false;
 		}
 
 		// Move semantics version
 		constexpr bool Push( value_type && new_elem )
 		{
-			return fStackPtr < kMaxSize ? fData[ fStackPtr ++ ] = new_elem, true : false;
+			return HasRoom() ? fData[ fStackPtr ++ ] = new_elem, true : false;
 		}
 
 
@@ -120,7 +160,7 @@ namespace BCForth
 		//		
 		constexpr bool Pop( value_type & ret_elem )
 		{
-			return fStackPtr > 0 ? ret_elem = std::move( fData[ -- fStackPtr ] ), true : false;		// if possible, "steal" from the top object, rather than copy (a fallback still possible)
+			return Has( 1 ) ? ret_elem = std::move( fData[ -- fStackPtr ] ), true : false;		// if possible, "steal" from the top object, rather than copy (a fallback still possible)
 		}
 
 
@@ -143,7 +183,7 @@ namespace BCForth
 		//	
 		constexpr bool Peek( value_type & ret_elem ) const
 		{
-			return fStackPtr > 0 ? ret_elem = fData[ fStackPtr - 1 ], true : false;		// here we need a strong copy
+			return Has( 1 ) ? ret_elem = fData[ fStackPtr - 1 ], true : false;		// here we need a strong copy
 		}
 
 	};
@@ -172,6 +212,8 @@ namespace BCForth
 
 		using BaseClass = Base;
 
+		using BaseClass::BaseClass;		// the capacity
+
 		using BaseClass::Push;
 		using BaseClass::Pop;
 		using BaseClass::Peek;
@@ -186,6 +228,7 @@ namespace BCForth
 
 		using BaseClass::fData;							// kind of a concept, i.e. the base class must have this 
 		using BaseClass::fStackPtr;
+		using BaseClass::Has;
 
 	public:
 
@@ -193,22 +236,22 @@ namespace BCForth
 		// Forth specific words - defined here for performance
 		constexpr bool Drop()
 		{
-			return fStackPtr > 0 ? -- fStackPtr, true : false;		
+			return Has( 1 ) ? -- fStackPtr, true : false;		
 		}
 
 		constexpr bool Dup()
 		{
-			return fStackPtr > 0 ? Push( fData[ fStackPtr - 1 ] ) : false;
+			return Has( 1 ) ? Push( fData[ fStackPtr - 1 ] ) : false;
 		}
 
 		constexpr bool Over()
 		{
-			return fStackPtr > 1 ? Push( fData[ fStackPtr - 2 ] ) : false;
+			return Has( 2 ) ? Push( fData[ fStackPtr - 2 ] ) : false;
 		}
 
 		constexpr bool Swap() const
 		{
-			if( fStackPtr >= 2 )
+			if( Has( 2 ) )
 			{
 				auto top { fData[ fStackPtr - 1 ] };
 				fData[ fStackPtr - 1 ] = fData[ fStackPtr - 2 ];
@@ -220,7 +263,7 @@ namespace BCForth
 
 		constexpr bool Rot() const
 		{
-			if( fStackPtr >= 3 )
+			if( Has( 3 ) )
 			{
 				auto top { fData[ fStackPtr - 3 ] };
 				fData[ fStackPtr - 3 ] = fData[ fStackPtr - 2 ];
@@ -231,9 +274,9 @@ namespace BCForth
 			return false;
 		}
 
-		constexpr bool Cells()		{ return fStackPtr > 0 ? fData[ fStackPtr - 1 ] *= sizeof( T ), true : false; }
+		constexpr bool Cells()		{ return Has( 1 ) ? fData[ fStackPtr - 1 ] *= sizeof( T ), true : false; }
 
-		constexpr bool CellPlus()	{ return fStackPtr > 0 ? fData[ fStackPtr - 1 ] += sizeof( T ), true : false; }
+		constexpr bool CellPlus()	{ return Has( 1 ) ? fData[ fStackPtr - 1 ] += sizeof( T ), true : false; }
 
 
 
@@ -241,21 +284,21 @@ namespace BCForth
 		template < typename Type2Read >
 		constexpr bool ReadAt()
 		{
-			return fStackPtr > 0 ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( * reinterpret_cast< Type2Read * >( fData[ fStackPtr - 1 ] ) ), true : false;
+			return Has( 1 ) ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( * reinterpret_cast< Type2Read * >( fData[ fStackPtr - 1 ] ) ), true : false;
 		}
 
 		// !
 		template < typename Type2Write >
 		constexpr bool WriteAt()
 		{
-			return fStackPtr > 1 ? * reinterpret_cast< Type2Write * >( fData[ fStackPtr - 1 ] ) = BlindValueReInterpretation< Type2Write >( fData[ fStackPtr - 2 ] ), fStackPtr -= 2, true : false;
+			return Has( 2 ) ? * reinterpret_cast< Type2Write * >( fData[ fStackPtr - 1 ] ) = BlindValueReInterpretation< Type2Write >( fData[ fStackPtr - 2 ] ), fStackPtr -= 2, true : false;
 		}
 
 		// C+!
 		template < typename Type2Write >
 		constexpr bool UpdateAt()
 		{
-			return fStackPtr > 1 ? * reinterpret_cast< Type2Write * >( fData[ fStackPtr - 1 ] ) += BlindValueReInterpretation< Type2Write >( fData[ fStackPtr - 2 ] ), fStackPtr -= 2, true : false;
+			return Has( 2 ) ? * reinterpret_cast< Type2Write * >( fData[ fStackPtr - 1 ] ) += BlindValueReInterpretation< Type2Write >( fData[ fStackPtr - 2 ] ), fStackPtr -= 2, true : false;
 		}
 
 
@@ -275,6 +318,8 @@ namespace BCForth
 
 		using BaseClass = Base;
 
+		using BaseClass::BaseClass;		// the capacity
+
 		using BaseClass::Push;
 		using BaseClass::Pop;
 		using BaseClass::Peek;
@@ -283,14 +328,15 @@ namespace BCForth
 
 		using BaseClass::fData;							// kind of a concept, i.e. the base class must have this 
 		using BaseClass::fStackPtr;
+		using BaseClass::Has;
 
 
 	public:
 
-		constexpr bool And()	{ return fStackPtr > 1 ? fData[ fStackPtr - 2 ] &= fData[ fStackPtr - 1 ], -- fStackPtr, true : false; }
-		constexpr bool Or()		{ return fStackPtr > 1 ? fData[ fStackPtr - 2 ] |= fData[ fStackPtr - 1 ], -- fStackPtr, true : false; }
-		constexpr bool Xor()	{ return fStackPtr > 1 ? fData[ fStackPtr - 2 ] ^= fData[ fStackPtr - 1 ], -- fStackPtr, true : false; }
-		constexpr bool Neg()	{ return fStackPtr > 0 ? fData[ fStackPtr - 1 ] = ~ fData[ fStackPtr - 1 ], true : false; }
+		constexpr bool And()	{ return Has( 2 ) ? fData[ fStackPtr - 2 ] &= fData[ fStackPtr - 1 ], -- fStackPtr, true : false; }
+		constexpr bool Or()		{ return Has( 2 ) ? fData[ fStackPtr - 2 ] |= fData[ fStackPtr - 1 ], -- fStackPtr, true : false; }
+		constexpr bool Xor()	{ return Has( 2 ) ? fData[ fStackPtr - 2 ] ^= fData[ fStackPtr - 1 ], -- fStackPtr, true : false; }
+		constexpr bool Neg()	{ return Has( 1 ) ? fData[ fStackPtr - 1 ] = ~ fData[ fStackPtr - 1 ], true : false; }
 
 	};
 
@@ -312,6 +358,8 @@ namespace BCForth
 
 		using BaseClass = Base;
 
+		using BaseClass::BaseClass;		// the capacity
+
 		using BaseClass::Push;
 		using BaseClass::Pop;
 		using BaseClass::Peek;
@@ -326,6 +374,8 @@ namespace BCForth
 
 		using BaseClass::fData;							// kind of a concept, i.e. the base class must have this 
 		using BaseClass::fStackPtr;
+		using BaseClass::Has;
+		using BaseClass::HasRoom;
 
 
 	public:
@@ -334,7 +384,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool Plus()
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) + top );
@@ -347,7 +397,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool Minus()
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) - top );
@@ -360,7 +410,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool Mult()
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) * top );
@@ -373,7 +423,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool Div()
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				if( top == A( 0 ) )
@@ -388,7 +438,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool Mod()
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				if( top == A( 0 ) )
@@ -409,7 +459,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool EQ()
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) == top ? kBoolTrue : kBoolFalse;
@@ -422,7 +472,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool NE() 
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) != top ? kBoolTrue : kBoolFalse;
@@ -435,7 +485,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool LT() 
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) < top ? kBoolTrue : kBoolFalse;
@@ -448,7 +498,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool LE()
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) <= top ? kBoolTrue : kBoolFalse;
@@ -461,7 +511,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool GT()
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) > top ? kBoolTrue : kBoolFalse;
@@ -474,7 +524,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool GE()
 		{
-			if( fStackPtr > 1 )
+			if( Has( 2 ) )
 			{
 				auto top { BlindValueReInterpretation< A >( fData[ -- fStackPtr ] ) };
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) >= top ? kBoolTrue : kBoolFalse;
@@ -492,7 +542,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool EQ_0()
 		{
-			if( fStackPtr > 0 )
+			if( Has( 1 ) )
 			{
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) == static_cast< A >( 0 ) ? kBoolTrue : kBoolFalse;
 				return true;
@@ -504,7 +554,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool NE_0()
 		{
-			if( fStackPtr > 0 )
+			if( Has( 1 ) )
 			{
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) != static_cast< A >( 0 ) ? kBoolTrue : kBoolFalse;
 				return true;
@@ -516,7 +566,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool GT_0()
 		{
-			if( fStackPtr > 0 )
+			if( Has( 1 ) )
 			{
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) > static_cast< A >( 0 ) ? kBoolTrue : kBoolFalse;
 				return true;
@@ -528,7 +578,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool GE_0()
 		{
-			if( fStackPtr > 0 )
+			if( Has( 1 ) )
 			{
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) >= static_cast< A >( 0 ) ? kBoolTrue : kBoolFalse;
 				return true;
@@ -540,7 +590,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool LT_0()
 		{
-			if( fStackPtr > 0 )
+			if( Has( 1 ) )
 			{
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) < static_cast< A >( 0 ) ? kBoolTrue : kBoolFalse;
 				return true;
@@ -552,7 +602,7 @@ namespace BCForth
 		template < typename A >
 		constexpr bool LE_0()
 		{
-			if( fStackPtr > 0 )
+			if( Has( 1 ) )
 			{
 				fData[ fStackPtr - 1 ] = BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) <= static_cast< A >( 0 ) ? kBoolTrue : kBoolFalse;
 				return true;
@@ -570,31 +620,195 @@ namespace BCForth
 		template < typename A >
 		constexpr bool OnePlus()
 		{
-			return  fStackPtr > 0 ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) + static_cast< A >( 1 ) ), true : false;
+			return  Has( 1 ) ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) + static_cast< A >( 1 ) ), true : false;
 		}
 
 		template < typename A >
 		constexpr bool OneMinus()
 		{
-			return  fStackPtr > 0 ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) - static_cast< A >( 1 ) ), true : false;
+			return  Has( 1 ) ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) - static_cast< A >( 1 ) ), true : false;
 		}
 
 		template < typename A >
 		constexpr bool TwoPlus()
 		{
-			return  fStackPtr > 0 ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) + static_cast< A >( 2 ) ), true : false;
+			return  Has( 1 ) ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) + static_cast< A >( 2 ) ), true : false;
 		}
 
 		template < typename A >
 		constexpr bool TwoMinus()
 		{
-			return  fStackPtr > 0 ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) - static_cast< A >( 2 ) ), true : false;
+			return  Has( 1 ) ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) - static_cast< A >( 2 ) ), true : false;
 		}
 
 		template < typename A >
 		constexpr bool TwoTimes()
 		{
-			return  fStackPtr > 0 ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) + BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) ), true : false;
+			return  Has( 1 ) ? fData[ fStackPtr - 1 ] = BlindValueReInterpretation< T >( BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) + BlindValueReInterpretation< A >( fData[ fStackPtr - 1 ] ) ), true : false;
+		}
+
+
+
+	public:
+
+		// The double-cell numbers - two cells, the more significant one on top (see TDoubleCellFor).
+		// As in Div, a division by 0 (or with a quotient which does not fit) throws.
+
+		// ( n -- d )
+		constexpr bool S_2_D()
+		{
+			if( Has( 1 ) && HasRoom() )
+			{
+				fData[ fStackPtr ] = TDoubleCellFor< T >::FromCell( fData[ fStackPtr - 1 ] ).second;
+				++ fStackPtr;
+				return true;
+			}
+
+			return false;
+		}
+
+		// ( d -- -d )
+		constexpr bool DNegate()
+		{
+			return Has( 2 ) ? std::tie( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ) = TDoubleCellFor< T >::Negate( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ), true : false;
+		}
+
+		// ( d1 d2 -- d1+d2 )
+		constexpr bool DPlus()
+		{
+			if( Has( 4 ) )
+			{
+				fStackPtr -= 2;
+				std::tie( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ) = TDoubleCellFor< T >::Plus( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ], fData[ fStackPtr ], fData[ fStackPtr + 1 ] );
+				return true;
+			}
+
+			return false;
+		}
+
+		// ( d1 d2 -- d1-d2 )
+		constexpr bool DMinus()
+		{
+			if( Has( 4 ) )
+			{
+				fStackPtr -= 2;
+				std::tie( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ) = TDoubleCellFor< T >::Minus( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ], fData[ fStackPtr ], fData[ fStackPtr + 1 ] );
+				return true;
+			}
+
+			return false;
+		}
+
+		// ( d1 d2 -- d1<d2 )
+		constexpr bool DLess()
+		{
+			if( Has( 4 ) )
+			{
+				fStackPtr -= 3;
+				fData[ fStackPtr - 1 ] = TDoubleCellFor< T >::Less( fData[ fStackPtr - 1 ], fData[ fStackPtr ], fData[ fStackPtr + 1 ], fData[ fStackPtr + 2 ] ) ? kBoolTrue : kBoolFalse;
+				return true;
+			}
+
+			return false;
+		}
+
+		// ( u1 u2 -- ud )
+		constexpr bool UMStar()
+		{
+			return Has( 2 ) ? std::tie( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ) = TDoubleCellFor< T >::Mul( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ), true : false;
+		}
+
+		// ( n1 n2 -- d )
+		constexpr bool MStar()
+		{
+			return Has( 2 ) ? std::tie( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ) = TDoubleCellFor< T >::SignedMul( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ), true : false;
+		}
+
+		// ( ud u -- rem quot )
+		constexpr bool UMSlashMod()
+		{
+			if( Has( 3 ) )
+			{
+				const auto d { fData[ -- fStackPtr ] };
+				if( d == T( 0 ) )
+					throw ForthError( "div by 0" );
+				if( fData[ fStackPtr - 1 ] >= d )
+					throw ForthError( "division overflow" );
+				std::tie( fData[ fStackPtr - 1 ], fData[ fStackPtr - 2 ] ) = TDoubleCellFor< T >::Div( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ], d );
+				return true;
+			}
+
+			return false;
+		}
+
+		// ( d n -- rem quot ), the quotient rounded toward 0
+		constexpr bool SMSlashRem()
+		{
+			if( Has( 3 ) )
+			{
+				const auto d { fData[ -- fStackPtr ] };
+				std::tie( fData[ fStackPtr - 1 ], fData[ fStackPtr - 2 ] ) = SignedDiv( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ], d );
+				return true;
+			}
+
+			return false;
+		}
+
+		// ( n1 n2 n3 -- rem quot ), with the double-cell n1*n2
+		constexpr bool StarSlashMod()
+		{
+			if( Has( 3 ) )
+			{
+				const auto d { fData[ -- fStackPtr ] };
+				const auto [ lo, hi ] { TDoubleCellFor< T >::SignedMul( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ) };
+				std::tie( fData[ fStackPtr - 1 ], fData[ fStackPtr - 2 ] ) = SignedDiv( lo, hi, d );
+				return true;
+			}
+
+			return false;
+		}
+
+		// ( n1 n2 n3 -- n1*n2/n3 ), with the double-cell n1*n2
+		constexpr bool StarSlash()
+		{
+			if( StarSlashMod() )
+			{
+				fData[ fStackPtr - 2 ] = fData[ fStackPtr - 1 ];
+				-- fStackPtr;
+				return true;
+			}
+
+			return false;
+		}
+
+		// ( d1 n1 n2 -- d1*n1/n2 ), with the triple-cell d1*n1
+		constexpr bool MStarSlash()
+		{
+			if( Has( 4 ) )
+			{
+				const auto d { fData[ -- fStackPtr ] };
+				const auto n { fData[ -- fStackPtr ] };
+				if( d == T( 0 ) )
+					throw ForthError( "div by 0" );
+				if( const auto r { TDoubleCellFor< T >::SignedMulDiv( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ], n, d ) } )
+					std::tie( fData[ fStackPtr - 2 ], fData[ fStackPtr - 1 ] ) = * r;
+				else
+					throw ForthError( "division overflow" );
+				return true;
+			}
+
+			return false;
+		}
+
+	private:
+
+		static constexpr auto SignedDiv( const T lo, const T hi, const T d )
+		{
+			if( d == T( 0 ) )
+				throw ForthError( "div by 0" );
+			if( const auto r { TDoubleCellFor< T >::SignedDiv( lo, hi, d ) } )
+				return * r;
+			throw ForthError( "division overflow" );
 		}
 
 
@@ -608,8 +822,8 @@ namespace BCForth
 
 
 	// Assembly them all together 
-	template < typename T, auto MaxElems >
-	using ForthStackFor = MSystemWordsStackFor< MLogicalOpsStackFor< MArithmeticOpsStackFor< TStackFor< T, MaxElems > > > >;
+	template < typename T, auto MaxElems, bool Checked = true >
+	using ForthStackFor = MSystemWordsStackFor< MLogicalOpsStackFor< MArithmeticOpsStackFor< TStackFor< T, MaxElems, Checked > > > >;
 
 
 
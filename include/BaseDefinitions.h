@@ -11,11 +11,12 @@
 #pragma once
 
 
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <type_traits>
 #include <vector>
-#include <regex>
 
 
 
@@ -31,25 +32,71 @@ namespace BCForth
 
 
 
-	using CellType	= size_t;
 	using RawByte	= unsigned char;
 	using Char		= char;
 
 	using size_type = size_t;
 
-	using SignedIntType = long long;		// it is good and efficient to have the SignedIntType 
-											// the same length as the basic CellType (otherwise e.g. address
-											// arithmetic causes address crop to 4 bytes if int is 4, etc.)
-	static_assert( sizeof( CellType ) == sizeof( SignedIntType ) );
 
-	using FloatType		= double;
-	static_assert( sizeof( CellType ) == sizeof( FloatType ) );
+
+	// The compile-time configuration of the Forth machine - its cells, its stacks and how it reads the names.
+	// The words are written for the types of the chosen policy (TForthPolicy below), so there is one per build.
+	template < typename Cell, typename SignedInt, typename Float, bool CheckedStacks = true, bool CaseInsensitive = true, size_type StackCells = 64 >
+	struct TForthPolicyFor
+	{
+		using CellType		= Cell;
+		using SignedIntType = SignedInt;		// it is good and efficient to have the SignedIntType 
+												// the same length as the basic CellType (otherwise e.g. address
+												// arithmetic causes address crop to 4 bytes if int is 4, etc.)
+		using FloatType		= Float;
+
+		static constexpr bool		kCheckedStacks		{ CheckedStacks };		// if false, an overflow hits a guard page
+		static constexpr bool		kCaseInsensitive	{ CaseInsensitive };	// anyway, all built-in words are uppercase
+		static constexpr size_type	kStackCells			{ StackCells };			// the default capacity of the stacks
+
+		static_assert( std::is_unsigned_v< CellType > && std::is_signed_v< SignedIntType > );
+		static_assert( sizeof( CellType ) == sizeof( SignedIntType ) );
+		static_assert( sizeof( CellType ) == sizeof( FloatType ) );
+		static_assert( sizeof( CellType ) >= sizeof( void * ), "the addresses are kept in the cells" );
+	};
+
+	// As it has always been
+	using TDefaultForthPolicy = TForthPolicyFor< size_t, long long, double >;
+
+	// Half the memory of the stacks and data - but only where the addresses fit in 32 bits
+	template < bool CheckedStacks = true, bool CaseInsensitive = true >
+	using TForth32PolicyFor = TForthPolicyFor< std::uint32_t, std::int32_t, float, CheckedStacks, CaseInsensitive >;
+
+
+	// The policy of this build, set with BCFORTH_CELL_BITS=32, BCFORTH_UNCHECKED_STACKS and BCFORTH_CASE_SENSITIVE
+#ifdef BCFORTH_UNCHECKED_STACKS
+	inline constexpr bool kBuildCheckedStacks { false };
+#else
+	inline constexpr bool kBuildCheckedStacks { true };
+#endif
+
+#ifdef BCFORTH_CASE_SENSITIVE
+	inline constexpr bool kBuildCaseInsensitive { false };
+#else
+	inline constexpr bool kBuildCaseInsensitive { true };
+#endif
+
+#if defined( BCFORTH_CELL_BITS ) && BCFORTH_CELL_BITS == 32
+	using TForthPolicy = TForth32PolicyFor< kBuildCheckedStacks, kBuildCaseInsensitive >;
+#else
+	using TForthPolicy = TForthPolicyFor< size_t, long long, double, kBuildCheckedStacks, kBuildCaseInsensitive >;
+#endif
+
+
+	using CellType		= TForthPolicy::CellType;
+	using SignedIntType = TForthPolicy::SignedIntType;
+	using FloatType		= TForthPolicy::FloatType;
 
 
 	constexpr auto CellTypeSize = sizeof( CellType );
 
 
-	constexpr auto FORTH_IS_CASE_INSENSITIVE { true };		// set to false to make Forth case sensitive (anyway, all built-in words are uppercase)
+	constexpr auto FORTH_IS_CASE_INSENSITIVE { TForthPolicy::kCaseInsensitive };
 
 
 	template< typename T >
@@ -64,7 +111,11 @@ namespace BCForth
 
 
 
-	enum EIntCompBase { kBin = 2, kOct = 8, kDec = 10, kHex = 16 };
+	// Any radix from kMinBase to kMaxBase can be set in BASE, these are only the most common ones
+	enum EIntCompBase : int { kBin = 2, kOct = 8, kDec = 10, kHex = 16 };
+
+	constexpr int kMinBase { 2 };
+	constexpr int kMaxBase { 36 };
 
 
 	// 8 kB for the PAD temporary storage area
@@ -94,8 +145,6 @@ namespace BCForth
 				const Name kBlanks { " \t\n" };
 
 
-				const std::regex kBlanksRe { "[[:s:]]+" }; // any whitespace, one or more times
-
 				const Name		kDotQuote	{ ".\"" };
 	constexpr	const Letter	kQuote		{ '\"' };
 
@@ -104,6 +153,10 @@ namespace BCForth
 				const Name		kSQuote		{ "S\"" };
 				const Name		kCQuote		{ "C\"" };
 
+				const Name		kSaveImage	{ "SAVE-IMAGE" };		// followed by a file path, which keeps its case
+				const Name		kInclude	{ "INCLUDE" };			// as well
+				const Name		kRequire	{ "REQUIRE" };
+
 	constexpr	const Letter kPlus			{ '+' };
 
 
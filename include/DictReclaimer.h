@@ -0,0 +1,274 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+#pragma once
+
+
+#include <map>
+#include <unordered_map>
+
+
+#include "ForthImage.h"
+
+
+
+
+namespace BCForth
+{
+
+
+
+	// A redefined word is only shadowed - it stays for the words compiled with it. Once no such word is left,
+	// the old word is garbage. This finds the words which can still be used: the visible ones, the system ones,
+	// and all those referred to by them - by their nodes, by the addresses in their literals and data cells,
+	// and by the cells on the stacks (e.g. an xt left by '). A value which only looks like such an address keeps
+	// its word as well, so nothing used is ever reclaimed. If a word has a node of an unknown kind, then what it
+	// refers to is not known, so nothing is reclaimed at all. A reclaimed word does not come back after FORGET.
+	template < typename ForthComp >
+	class TDictReclaimerFor
+	{
+		using WordPtr		= TForth::WordPtr;
+		using WordEntry		= TForth::WordEntry;
+
+		using Image			= TForthImageFor< ForthComp >;
+		using CW			= CompoWord< TForth >;
+
+		ForthComp &		fForth;
+
+		std::vector< std::pair< const Name *, WordEntry * > >	fDefs;		// all words, in the order of their definitions
+
+		std::unordered_map< CellType, size_type >				fNodeOwners;	// the address of a node (or of its branch) -> its definition
+		std::map< CellType, std::pair< size_type, size_type > >	fDataOwners;	// the beginning of data -> its size and definition
+
+		std::vector< bool >			fUsed;
+		std::vector< size_type >	fToVisit;
+
+		bool			fUnknownNodes { false };		// then all words are kept
+
+	public:
+
+		TDictReclaimerFor( ForthComp & f ) : fForth( f ) {}
+
+	public:
+
+		struct Stats
+		{
+			size_type	fNumLiveNodes {};
+			size_type	fNumGarbageWords {};
+			size_type	fNumGarbageNodes {};
+		};
+
+		// Counts the nodes, without reclaiming anything
+		Stats GetStats( void )
+		{
+			Stats stats;
+
+			const auto garbage { FindGarbage() };
+			for( size_type seq {}; seq < fDefs.size(); ++ seq )
+				if( ! fDefs[ seq ].second->fWordIsReclaimed )
+					( fUsed[ seq ] || fUnknownNodes ? stats.fNumLiveNodes : stats.fNumGarbageNodes ) += NumOfNodes( seq );
+
+			stats.fNumGarbageWords = garbage.size();
+			return stats;
+		}
+
+		// Destroys the garbage words, returns their number
+		size_type Reclaim( void )
+		{
+			const auto garbage { FindGarbage() };
+			for( const auto seq : garbage )
+				fForth.ReclaimWord( * fDefs[ seq ].first, * fDefs[ seq ].second );
+
+			return garbage.size();
+		}
+
+	private:
+
+		// The shadowed words not used by any other
+		std::vector< size_type > FindGarbage( void )
+		{
+			const auto & def_log { fForth.GetDefLog() };
+			const auto & repo { fForth.GetNodeRepo() };
+
+			fDefs.assign( def_log.size(), {} );
+			for( typename ForthComp::WordListID wid {}; wid < fForth.GetNumOfWordLists(); ++ wid )
+				for( auto && [ name, entry ] : fForth.GetWordList( wid ) )
+					fDefs[ entry.fDefSeq ] = { & name, & entry };
+
+			fNodeOwners.clear();
+			fDataOwners.clear();
+			fUsed.assign( fDefs.size(), false );
+			fToVisit.clear();
+			fUnknownNodes = false;
+
+			// Where each node is
+			auto add_node = [ this ] ( const WordPtr wp, const size_type seq )
+			{
+				fNodeOwners.emplace( reinterpret_cast< CellType >( wp ), seq );
+				Image::ForEachBranch( wp, [ & ] ( const size_type, CW & b ) { fNodeOwners.emplace( reinterpret_cast< CellType >( & b ), seq ); } );
+
+				if( const auto [ data, size ] = Image::DataOf( wp ); size > 0 )
+					fDataOwners[ reinterpret_cast< CellType >( data ) ] = { size, seq };
+			};
+
+			for( size_type seq {}; seq < fDefs.size(); ++ seq )
+			{
+				const auto entry { fDefs[ seq ].second };
+				if( entry->fWordIsReclaimed )
+					continue;
+
+				add_node( entry->fWordUP.get(), seq );
+				if( const auto wp { fForth.GetWordPtr( * entry ) }; wp != entry->fWordUP.get() )
+					add_node( wp, seq );		// the word made by a lazy module
+
+				for( auto [ i, end ] { fForth.GetDefNodes( seq ) }; i < end; ++ i )
+					if( repo[ i ] )
+						add_node( repo[ i ].get(), seq );
+			}
+
+			// The system words, the visible ones and those on the stacks are in use - and all below the last
+			// MARKER, since they come back once it is executed
+			auto kNumSystemDefs { std::max( fForth.GetDictFence(), fForth.GetNumOfNativeDefs() ) };
+			for( size_type seq {}; seq < fDefs.size(); ++ seq )
+				if( const auto entry { fDefs[ seq ].second }; ! entry->fWordIsReclaimed && dynamic_cast< Marker< TForth > * >( entry->fWordUP.get() ) )
+					kNumSystemDefs = std::max( kNumSystemDefs, seq );
+
+			for( size_type seq {}; seq < fDefs.size(); ++ seq )
+				if( const auto & [ name, entry ] { fDefs[ seq ] }; ! entry->fWordIsReclaimed )
+					if( seq < kNumSystemDefs || entry->fWordIsLazy || fForth.GetWordList( def_log[ seq ].fWordList ).find( * name ) == entry )
+						Use( seq );
+
+			for( const auto & stack : { std::pair( fForth.GetDataStack().data(), fForth.GetDataStack().size() ), std::pair( fForth.GetRetStack().data(), fForth.GetRetStack().size() ) } )
+				for( size_type i {}; i < stack.second; ++ i )
+					Visit( stack.first[ i ] );
+
+			// And all they refer to
+			while( fToVisit.size() > 0 )
+			{
+				const auto seq { fToVisit.back() };
+				fToVisit.pop_back();
+
+				const auto entry { fDefs[ seq ].second };
+				if( seq < fForth.GetNumOfNativeDefs() )
+				{
+					VisitData( entry->fWordUP.get() );		// only the data of the C++ words, such as PAD
+					continue;
+				}
+
+				fUnknownNodes |= ! VisitNode( entry->fWordUP.get() );
+
+				for( auto [ i, end ] { fForth.GetDefNodes( seq ) }; i < end; ++ i )
+					if( repo[ i ] )
+						fUnknownNodes |= ! VisitNode( repo[ i ].get() );
+			}
+
+			if( fUnknownNodes )
+				return {};
+
+			std::vector< size_type > garbage;
+			for( auto seq { kNumSystemDefs }; seq < fDefs.size(); ++ seq )
+				if( ! fUsed[ seq ] && ! fDefs[ seq ].second->fWordIsReclaimed )
+					garbage.push_back( seq );
+
+			return garbage;
+		}
+
+		void Use( const size_type seq )
+		{
+			if( ! fUsed[ seq ] )
+				fUsed[ seq ] = true, fToVisit.push_back( seq );
+		}
+
+		// v can be an address of a node, or of some data
+		void Visit( const CellType v )
+		{
+			if( v == 0 )
+				return;
+
+			if( const auto pos { fNodeOwners.find( v ) }; pos != fNodeOwners.end() )
+				return Use( pos->second );
+
+			if( auto pos { fDataOwners.upper_bound( v ) }; pos != fDataOwners.begin() )
+				if( -- pos; v - pos->first <= pos->second.first )		// the end of the data is also fine
+					Use( pos->second.second );
+		}
+
+		void VisitWords( const typename CW::WordsVec & words )
+		{
+			for( const auto wp : words )
+				Visit( reinterpret_cast< CellType >( wp ) );
+		}
+
+		void VisitData( const WordPtr wp )
+		{
+			if( auto * arr = dynamic_cast< RawByteArray< TForth > * >( wp ) )
+			{
+				const auto data { arr->GetData() };
+				for( size_type offset {}; offset + sizeof( CellType ) <= data.size(); offset += sizeof( CellType ) )
+				{
+					CellType v {};
+					std::memcpy( & v, data.data() + offset, sizeof( v ) );
+					Visit( v );
+				}
+			}
+		}
+
+		// Returns false if the node is of an unknown kind
+		bool VisitNode( const WordPtr wp )
+		{
+			if( const auto kind { Image::KindOf( wp ) } )
+			{
+				using ENode = typename Image::ENode;
+
+				switch( * kind )
+				{
+					case ENode::kCompo:
+					case ENode::kCase:
+						VisitWords( static_cast< CW * >( wp )->GetWordsVec() );
+						break;
+
+					case ENode::kPostpone:
+						Visit( reinterpret_cast< CellType >( static_cast< Postpone< TForth > * >( wp )->GetWordPtr() ) );
+						break;
+
+					case ENode::kCellVal:
+						Visit( static_cast< CellValWord< TForth > * >( wp )->GetVal() );
+						break;
+
+					case ENode::kByteArray:
+						VisitData( wp );
+						break;
+
+					default:
+						Image::ForEachBranch( wp, [ this ] ( const size_type, CW & b ) { VisitWords( b.GetWordsVec() ); } );
+						break;
+				}
+
+				return true;
+			}
+
+			return dynamic_cast< VocabularyWord< TForth > * >( wp ) || dynamic_cast< Marker< TForth > * >( wp );
+		}
+
+		size_type NumOfNodes( const size_type seq ) const
+		{
+			const auto [ first, end ] { fForth.GetDefNodes( seq ) };
+			size_type n { fDefs[ seq ].second->fWordUP ? 1u : 0u };
+			for( auto i { first }; i < end; ++ i )
+				n += fForth.GetNodeRepo()[ i ] != nullptr;
+			return n;
+		}
+
+	};
+
+
+
+}	// The end of the BCForth namespace
+
@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <deque>
 #include <sstream>
 #include <string>
 #include <algorithm>
@@ -28,6 +29,9 @@
 
 
 #include "Words.h"
+#include "SymbolTable.h"
+#include "NodeArena.h"
+#include "DataSpace.h"
 
 
 
@@ -43,20 +47,70 @@ namespace BCForth
 
 
 
-	// Space for the basic Forth's data structures
-	class TForth
+	// Space for the basic Forth's data structures. The Policy sets the stacks, see TForthPolicyFor 
+	// (its cell and float types should be those of TForthPolicy, for which all the words are written).
+	template < typename Policy >
+	class TForthFor
 	{
+		static_assert( std::is_same_v< typename Policy::CellType, CellType > && std::is_same_v< typename Policy::FloatType, FloatType > );
+
 	public:
 
-		virtual ~TForth() = default;
+		using PolicyType = Policy;
+
+	private:
+
+		TNodeArena		fNodeArena;			// all word nodes live here - it has to go first, so it is destroyed after all the nodes
+
+		TNodeArena		fModuleArena;		// the words of the lazy modules, which are made later but never rewound
+
+		TNodeArena *	fNewNodeArena { & fNodeArena };		// where the nodes made now go (see MakeWord)
+
+		static inline thread_local TNodeArena *	fRecyclingArena {};		// set only while the garbage words are reclaimed
 
 	public:
 
-		static const size_t kStackMaxCells { 64 };	// change for low memory systems
+		// The capacities of the stacks (in cells) can be set for each Forth - with no cells 
+		// for the floating-point stack, the floats go to the data stack (as before)
+		explicit TForthFor( const size_type data_stack_cells = kStackMaxCells, const size_type ret_stack_cells = kStackMaxCells, const size_type float_stack_cells = 0,
+							const size_type data_space_bytes = kDataSpaceBytes )
+			: fDataStack( data_stack_cells ), fRetStack( ret_stack_cells ), 
+				fFloatStack( std::max< size_type >( float_stack_cells, 1 ) ), fHasFloatStack( float_stack_cells > 0 ), fDataSpace( data_space_bytes )
+		{
+			NewWordList( "FORTH" );						// the first one, i.e. kForthWordList
+			NewWordList( "ROOT" );						// kRootWordList
+			fSearchOrder.Push( kForthWordList );
+		}
+
+		virtual ~TForthFor() = default;
 
-		using DataStack = ForthStackFor< CellType, kStackMaxCells >;
+		TForthFor( const TForthFor & ) = delete;
+		TForthFor & operator = ( const TForthFor & ) = delete;
 
-		using RetStack = TStackFor< CellType, kStackMaxCells >;
+
+		TNodeArena &	GetNodeArena( void ) { return fNodeArena; }
+
+		// The arena for the nodes made now - the node arena, or the module one while a lazy module is loaded
+		TNodeArena &	GetNewNodeArena( void ) { return * fNewNodeArena; }
+
+		// The arena which takes back the memory of the deleted nodes, or nullptr
+		static TNodeArena * GetRecyclingArena( void ) { return fRecyclingArena; }
+
+	public:
+
+		static const size_t kStackMaxCells { Policy::kStackCells };	// the default capacity of the stacks - smaller in the policy of a low memory system
+
+		// With no checks, the stack operations do not count the cells
+		// - an overflow (or underflow) hits a guard page and ends the program
+		static constexpr bool kCheckedStacks { Policy::kCheckedStacks };
+
+		using DataStack = ForthStackFor< CellType, kStackMaxCells, kCheckedStacks >;
+
+		using RetStack = TStackFor< CellType, kStackMaxCells, kCheckedStacks >;
+
+		using FloatStack = ForthStackFor< FloatType, kStackMaxCells, kCheckedStacks >;
+
+		static const size_t kDataSpaceBytes { 64 * 1024 * 1024 };	// only reserved - the pages are taken when used
 
 	public:
 
@@ -64,31 +118,120 @@ namespace BCForth
 
 		RetStack &	GetRetStack( void ) { return fRetStack; }	
 
+		FloatStack & GetFloatStack( void ) { return fFloatStack; }
+
+		// True if the floats go to their own stack, rather than to the data stack
+		bool		HasFloatStack( void ) const { return fHasFloatStack; }
+
+
+		// Position in the return stack of the locals frame of the currently executed word
+		size_type	GetLocalsFrame( void ) const { return fLocalsFrame; }
+		void		SetLocalsFrame( size_type frame ) { fLocalsFrame = frame; }
+
 
 	public:
 
-		using WordPtr = TWord< TForth > *;
+		TDataSpace & GetDataSpace( void ) { return fDataSpace; }
+
+		// Reserves n bytes at HERE (ALLOT , C, etc.) - if they follow the data field of the last CREATEd word, then they go to it
+		RawByte * AllotData( const size_type n )
+		{
+			const auto p { fDataSpace.Allot( n ) };
+			if( fLastDataField != nullptr )
+				if( const auto field { fLastDataField->GetData() }; field.data() + field.size() == p )
+					fLastDataField->Resize( field.size() + n );
+			return p;
+		}
+
+		// Returns the aligned HERE
+		RawByte * AlignData( void )
+		{
+			AllotData( fDataSpace.Padding() );
+			return fDataSpace.Here();
+		}
+
+		// Gives back the last n bytes, which can be only of the last data field (ALLOT with n < 0)
+		void FreeData( const size_type n )
+		{
+			if( fLastDataField == nullptr )
+				throw ForthError( "no data to free" );
 
-		using WordUP = std::unique_ptr< TWord< TForth > >;
+			const auto field { fLastDataField->GetData() };
+			if( field.data() + field.size() != fDataSpace.Here() || n > field.size() )
+				throw ForthError( "cannot free the data of other words" );
 
-	protected: 
+			fDataSpace.Free( n );
+			fLastDataField->Resize( field.size() - n );
+		}
 
-		// The main record to store all information about each word in the system
-		// These are held in the fWordDict
+		// Called by the new data field (CREATE) - the data of the word to be defined start there
+		void SetLastDataField( RawByteArray< TForthFor > * field )
+		{
+			fLastDataField = field;
+			if( ! fNewDataMark )
+				fNewDataMark = fDataSpace.Used();
+		}
+
+		void DropDataField( const RawByteArray< TForthFor > * field )
+		{
+			if( fLastDataField == field )
+				fLastDataField = nullptr;
+		}
+
+
+	public:
+
+		using WordPtr = TWord< TForthFor > *;
+
+		using WordUP = std::unique_ptr< TWord< TForthFor > >;
+
+	public: 
+
+		// The record of each word in the system, held in the wordlists. Only what is needed to find
+		// and run the word goes here - its other data, such as the comment, is in its fDefLog entry.
 		struct WordEntry
 		{
 			WordUP	fWordUP;
+			size_type	fDefSeq {};								// its position in the fDefLog
 			bool	fWordIsCompiled		: 1		{ false };		// set if a word is currently compiled 
 			bool	fWordIsImmediate	: 1		{ false };		// set if a word is immediate (executed during compilation of other words)
 			bool	fWordIsDefining		: 1		{ false };		// set if a word contains DOES> in its definition
-			Name	fWordComment;								// commenting text of this word
+			bool	fWordIsValue		: 1		{ false };		// set if it was made by VALUE - only then TO can store to it
+			bool	fWordIsLazy			: 1		{ false };		// set if it is a LazyWord of a module
+			bool	fWordIsReclaimed	: 1		{ false };		// set if it was shadowed and not used anymore - then it has no nodes
 			// reserved for further data
 		};
 
 		using WordOptional = std::optional< WordEntry * >;
 
 
-		using WordDict = std::unordered_map< Name, WordEntry >;		// for low memory systems change to std::map
+		using WordDict = TSymbolMapFor< WordEntry >;		// the names are interned, the lookups go with std::string_view
+
+
+	public:
+
+		// The wordlists are identified by their indices
+		using WordListID = CellType;
+
+		static constexpr WordListID kForthWordList {};
+
+		static constexpr WordListID kRootWordList { 1 };		// the search order words - searched after the search order, so these are always found
+
+		static const size_t kMaxSearchOrder { 16 };
+
+		using SearchOrder = TStackFor< WordListID, kMaxSearchOrder >;		// the top wordlist is searched first
+
+	protected:
+
+		// Each wordlist is a separate dictionary, so its table is as small as its words
+		struct WordList
+		{
+			WordDict	fDict;
+			Name		fName;			// a name of its VOCABULARY, or empty if created with WORDLIST
+			size_type	fDefSeq {};		// the number of the definitions before this wordlist was created
+		};
+
+		using WordLists = std::deque< WordList >;		// adding a wordlist does not move the others
 
 
 
@@ -98,9 +241,54 @@ namespace BCForth
 		DataStack		fDataStack;			// the main Forth's data structure
 
 		RetStack		fRetStack;			// the second stack, called a "return" stack in Forth frameworks
-											// (not used, left only for user's convenience)
+											// (used by >R, R> etc. and to hold the frames of local variables)
+
+		FloatStack		fFloatStack;		// the floats, if fHasFloatStack (then the F-words and the float literals use it)
+
+		bool			fHasFloatStack {};
+
+		TDataSpace		fDataSpace;			// the data of all the CREATEd words, one after another
+
+		RawByteArray< TForthFor > *	fLastDataField {};		// the one which grows with ALLOT, , etc.
+
+		std::optional< size_type >	fNewDataMark;			// the data space used before the CREATE of the next word
+
+		size_type		fLocalsFrame {};	// the first return stack cell of the current {: ... :} frame
 
-		WordDict		fWordDict;			// a dictionary with all Forth's words
+		WordLists		fWordLists;			// all Forth's words, grouped into the wordlists
+
+		SearchOrder		fSearchOrder;		// the wordlists in which the words are looked for
+
+		WordListID		fCurrent { kForthWordList };	// the wordlist the new words go to
+
+		size_type		fDictGeneration { 1 };	// changed on each change of the wordlists or the search order, so anything derived from them can be checked for validity
+
+
+		// Each entry to a wordlist is logged, so the dictionary can be rewound to an earlier state.
+		// The log also holds the data of the words which is not used to run them (WORDS, FIND, the images).
+		struct DefLogEntry
+		{
+			WordListID	fWordList {};
+			size_type	fNodeMark {};		// the fNodeRepo size at the previous definition - the nodes above it belong to this one
+			TNodeArena::Mark	fArenaMark;	// the same for the node arena
+			size_type	fDataMark {};		// the data space used before the word
+			Name		fWordComment;		// commenting text of the word
+		};
+
+		std::vector< DefLogEntry >	fDefLog;
+
+		size_type		fDefNodeMark {};	// the fNodeRepo size at the last definition
+		TNodeArena::Mark	fDefArenaMark;	// and the arena position
+
+		size_type		fDictFence {};		// the definitions below cannot be forgotten
+
+		size_type		fNumNativeDefs {};	// the definitions of the words written in C++, which go first
+
+		size_type		fNumDictRewinds {};	// MARKER and FORGET calls so far
+
+		size_type		fNumShadowings {};		// the words entered with the names already in their wordlists
+
+		size_type		fNumReclaimedNodes {};	// the nodes of the garbage words, destroyed so far
 
 
 	protected:
@@ -125,25 +313,458 @@ namespace BCForth
 
 	public:
 
-		WordDict &	GetWordDict( void ) { return fWordDict; }
-
-
-		// Returns false if the word already exists
-		WordPtr InsertWord_2_Dict( Name name, WordUP wp, Name comment_str = "", bool compiled = false, bool immediate = false, bool defining = false )
+		// The new word goes to the current wordlist
+		WordPtr InsertWord_2_Dict( Name name, WordUP wp, Name comment_str = "", bool compiled = false, bool immediate = false, bool defining = false, bool value = false )
 		{
+			if( fLoadingModule )
+				return SetLazyWord( name, std::move( wp ), std::move( comment_str ) );
+
 			WordPtr retPtr { wp.get() };
-			fWordDict[ name ] = WordEntry( std::move( wp ), compiled, immediate, defining, comment_str );
+			InsertEntry_2_Dict( name, WordEntry( std::move( wp ), {}, compiled, immediate, defining, value ), std::move( comment_str ) );
 			return retPtr;
 		}
 
+		size_type GetDictGeneration( void ) const { return fDictGeneration; }
+
+	protected:
+
+		// Should be called after each direct change of the wordlists
+		void DictChanged( void ) { ++ fDictGeneration; }
+
+
+		// All new words go this way - if the name is already in the current wordlist, 
+		// then the old word is shadowed but it stays alive for the words which use it
+		void InsertEntry_2_Dict( const Name & name, WordEntry && entry, Name comment_str = "" )
+		{
+			entry.fDefSeq = fDefLog.size();
+
+			auto & dict { fWordLists[ fCurrent ].fDict };
+			if( dict.find( name ) )
+				++ fNumShadowings;
+			dict.Insert( name, std::move( entry ) );
+
+			fDefLog.push_back( { fCurrent, fDefNodeMark, fDefArenaMark, fNewDataMark.value_or( fDataSpace.Used() ), std::move( comment_str ) } );
+			fNewDataMark.reset();
+			fDefNodeMark = fNodeRepo.size();
+			fDefArenaMark = fNodeArena.GetMark();
+
+			DictChanged();
+		}
+
+
+	public:
+
+		// A state of the dictionary which it can be rewound to (MARKER, FORGET)
+		struct DictMark
+		{
+			size_type					fNumDefs {};
+			size_type					fNumNodes {};
+			TNodeArena::Mark			fArenaMark;
+			size_type					fDataMark {};
+			size_type					fNumWordLists {};
+			std::vector< WordListID >	fSearchOrder;
+			WordListID					fCurrent { kForthWordList };
+		};
+
+
+		DictMark GetDictMark( void ) const
+		{
+			return { fDefLog.size(), fNodeRepo.size(), fNodeArena.GetMark(), fDataSpace.Used(), fWordLists.size(), 
+						std::vector< WordListID >( fSearchOrder.data(), fSearchOrder.data() + fSearchOrder.size() ), fCurrent };
+		}
+
+		// The state just before the word was defined (FORGET)
+		DictMark GetDictMarkOf( const WordEntry & entry ) const
+		{
+			const auto seq { entry.fDefSeq };
+			assert( seq < fDefLog.size() );
+
+			DictMark mark { seq, fDefLog[ seq ].fNodeMark, fDefLog[ seq ].fArenaMark, fDefLog[ seq ].fDataMark, fWordLists.size(), 
+								std::vector< WordListID >( fSearchOrder.data(), fSearchOrder.data() + fSearchOrder.size() ), fCurrent };
+
+			while( mark.fNumWordLists > 0 && fWordLists[ mark.fNumWordLists - 1 ].fDefSeq > seq )
+				-- mark.fNumWordLists;		// these were created after the word
+
+			return mark;
+		}
+
+
+		// Removes all the words, wordlists and nodes created after the mark. The time is proportional
+		// to the number of the removed words and nodes, the older ones are not touched at all;
+		// their memory goes back at once with the node arena.
+		void RewindDict( const DictMark & mark )
+		{
+			if( mark.fNumDefs < fDictFence )
+				throw ForthError( "cannot forget the system words" );
+
+			for( ; fDefLog.size() > mark.fNumDefs; fDefLog.pop_back() )
+				fWordLists[ fDefLog.back().fWordList ].fDict.PopBack();
+
+			if( mark.fNumWordLists < fWordLists.size() )
+				fWordLists.erase( fWordLists.begin() + mark.fNumWordLists, fWordLists.end() );
+
+			if( mark.fNumNodes < fNodeRepo.size() )
+				fNodeRepo.erase( fNodeRepo.begin() + mark.fNumNodes, fNodeRepo.end() );
+
+			fNodeArena.Rewind( mark.fArenaMark );		// all the nodes above are already destroyed
+
+			// So are the data fields above, and the data of the last one can be cut
+			fDataSpace.Rewind( mark.fDataMark );
+			fNewDataMark.reset();
+			if( fLastDataField != nullptr )
+				if( const auto field { fLastDataField->GetData() }; field.data() + field.size() > fDataSpace.Here() )
+					fLastDataField->Resize( fDataSpace.Here() - field.data() );
+
+			fDefNodeMark = mark.fNumNodes;
+			fDefArenaMark = mark.fArenaMark;
+
+			// The removed wordlists cannot be searched anymore
+			fSearchOrder.clear();
+			for( const auto wid : mark.fSearchOrder )
+				if( wid < fWordLists.size() )
+					fSearchOrder.Push( wid );
+			if( fSearchOrder.size() == 0 )
+				fSearchOrder.Push( kForthWordList );
+
+			fCurrent = mark.fCurrent < fWordLists.size() ? mark.fCurrent : kForthWordList;
+
+			++ fNumDictRewinds;
+			DictChanged();
+		}
+
+		// Tells whether the dictionary has been rewound since the number was read
+		size_type GetNumOfDictRewinds( void ) const { return fNumDictRewinds; }
+
+	public:
+
+		// The nodes of the definition are [ first, second ) in the fNodeRepo
+		std::pair< size_type, size_type > GetDefNodes( const size_type seq ) const
+		{
+			assert( seq < fDefLog.size() );
+			return { fDefLog[ seq ].fNodeMark, seq + 1 < fDefLog.size() ? fDefLog[ seq + 1 ].fNodeMark : fDefNodeMark };
+		}
+
+		// Tells whether a word has been shadowed since the number was read, i.e. some words can be garbage
+		size_type GetNumOfShadowings( void ) const { return fNumShadowings; }
+
+		size_type GetNumOfReclaimedNodes( void ) const { return fNumReclaimedNodes; }
+
+		// Destroys the word and its nodes - it must be shadowed and not used by any other word (see TDictReclaimerFor). 
+		// Its entry stays in the wordlist, only taken out of the chain of its name, so the definitions keep their 
+		// positions, the marks are still valid and the word is not visible again when the ones shadowing it are forgotten.
+		void ReclaimWord( const Name & name, WordEntry & entry )
+		{
+			assert( entry.fDefSeq >= fNumNativeDefs && ! entry.fWordIsLazy && ! entry.fWordIsReclaimed );
+
+			if( ! fWordLists[ fDefLog[ entry.fDefSeq ].fWordList ].fDict.Unlink( name, & entry ) )
+				return;
+
+			fRecyclingArena = & fNodeArena;		// the memory of the nodes goes back to the arena
+
+			if( entry.fWordUP )
+				entry.fWordUP.reset(), ++ fNumReclaimedNodes;
+
+			for( auto [ i, end ] { GetDefNodes( entry.fDefSeq ) }; i < end; ++ i )
+				if( fNodeRepo[ i ] )
+					fNodeRepo[ i ].reset(), ++ fNumReclaimedNodes;
+
+			fRecyclingArena = nullptr;
+
+			entry.fWordIsReclaimed = true;
+			DictChanged();
+		}
+
+		// The same state as left by ReclaimWord (used by the images)
+		void InsertReclaimedWord_2_Dict( const Name & name, const size_type num_nodes, Name comment_str )
+		{
+			for( size_type i {}; i < num_nodes; ++ i )
+				fNodeRepo.emplace_back();
+
+			InsertEntry_2_Dict( name, WordEntry(), std::move( comment_str ) );
+
+			auto & entry { * fWordLists[ fCurrent ].fDict.find( name ) };
+			fWordLists[ fCurrent ].fDict.Unlink( name, & entry );
+			entry.fWordIsReclaimed = true;
+			DictChanged();
+		}
+
+
+	public:
+
+		// The lazy modules enter only the names of their words at first (as LazyWord-s), 
+		// then all the words of a module are made when one of them is called for the first time
+		using ModuleLoader = std::function< void ( void ) >;
+
+		size_type RegisterLazyModule( Name name, ModuleLoader loader )
+		{
+			fLazyModules.push_back( { std::move( name ), std::move( loader ) } );
+			return fLazyModules.size() - 1;
+		}
+
+		// Its words go to the current wordlist
+		void InsertLazyWords_2_Dict( const size_type module, const Names & names )
+		{
+			for( const auto & name : names )
+			{
+				WordEntry entry { MakeWord< LazyWord< TForthFor > >( * this, module ) };
+				entry.fWordIsLazy = true;
+				InsertEntry_2_Dict( name, std::move( entry ) );
+			}
+		}
+
+		const Name & GetModuleName( const size_type module ) const { return fLazyModules.at( module ).fName; }
+
+		// Makes the words of the module, if not made yet (REQUIRE-MODULE)
+		void RequireModule( const size_type module )
+		{
+			auto & lazy_module { fLazyModules.at( module ) };
+			if( lazy_module.fLoaded )
+				return;
+
+			// The words are made in their own arena, since they stay with their LazyWord-s, below the fence
+			const auto prev_arena { std::exchange( fNewNodeArena, & fModuleArena ) };
+			fLoadingModule = true;
+
+			try
+			{
+				lazy_module.fLoader();
+			}
+			catch( ... )
+			{
+				fNewNodeArena = prev_arena;
+				fLoadingModule = false;
+				throw;
+			}
+
+			fNewNodeArena = prev_arena;
+			fLoadingModule = false;
+
+			lazy_module.fLoaded = true;
+		}
+
+		void RequireModule( const std::string_view name )
+		{
+			const auto pos { std::find_if( fLazyModules.begin(), fLazyModules.end(), [ name ] ( const auto & m ) { return m.fName == name; } ) };
+			if( pos == fLazyModules.end() )
+				throw ForthError( "unknown module - " + Name( name ) );
+
+			RequireModule( static_cast< size_type >( pos - fLazyModules.begin() ) );
+		}
+
+		// The node to be called for the word - the word of a module is called directly, once it is made
+		WordPtr GetWordPtr( const WordEntry & entry ) const
+		{
+			if( entry.fWordIsLazy )
+				if( const auto real_word { static_cast< const LazyWord< TForthFor > & >( * entry.fWordUP ).GetRealWord() } )
+					return real_word;
+
+			return entry.fWordUP.get();
+		}
+
+	private:
+
+		struct LazyModule
+		{
+			Name			fName;
+			ModuleLoader	fLoader;
+			bool			fLoaded {};
+		};
+
+		std::vector< LazyModule >	fLazyModules;
+
+		bool			fLoadingModule {};		// set while a lazy module makes its words
+
+		// The word made by a lazy module goes to its LazyWord in the current wordlist
+		WordPtr SetLazyWord( const Name & name, WordUP wp, Name comment_str )
+		{
+			const auto entry { fWordLists[ fCurrent ].fDict.find( name ) };
+			if( ! entry || ! entry->fWordIsLazy )
+				throw ForthError( "the word " + name + " is missing from the manifest of its module" );
+
+			auto & lazy_word { static_cast< LazyWord< TForthFor > & >( * entry->fWordUP ) };
+			lazy_word.SetRealWord( std::move( wp ) );
+			fDefLog[ entry->fDefSeq ].fWordComment = std::move( comment_str );
+
+			return lazy_word.GetRealWord();
+		}
+
+	public:
+
+		// The words defined so far cannot be forgotten
+		void SetDictFence( void ) { fDictFence = fDefLog.size(); }
+
+		size_type GetDictFence( void ) const { return fDictFence; }
+
+
+		// The words defined so far are written in C++ - these are not stored in the images,
+		// only their names, since such a word can be found only by running its module
+		void SetNativeDefs( void ) { fNumNativeDefs = fDefLog.size(); }
+
+		size_type GetNumOfNativeDefs( void ) const { return fNumNativeDefs; }
+
+		const auto & GetDefLog( void ) const { return fDefLog; }
+
+		// The memory of the dictionary: the hot part is used to find and run the words (the wordlists),
+		// the cold one only to define, list and save them (the definition log with the comments)
+		std::pair< size_type, size_type > GetDictBytes( void ) const
+		{
+			size_type hot {}, cold { fDefLog.capacity() * sizeof( DefLogEntry ) };
+			for( const auto & wl : fWordLists )
+				hot += wl.fDict.GetNumOfBytes();
+			for( const auto & def : fDefLog )
+				if( def.fWordComment.capacity() > Name().capacity() )
+					cold += def.fWordComment.capacity() + 1;
+			return { hot, cold };
+		}
+
+		const Name & GetWordComment( const WordEntry & entry ) const { return fDefLog[ entry.fDefSeq ].fWordComment; }
+
+
+		// A word cannot remove itself while it runs, so MARKER only requests the rewind,
+		// which is done by the interpreter when the outermost word returns
+		void RequestDictRewind( DictMark mark ) { fPendingDictRewind = std::move( mark ); }
+
+		void RewindDictIfRequested( void )
+		{
+			if( fPendingDictRewind )
+			{
+				const auto mark { std::move( * fPendingDictRewind ) };
+				fPendingDictRewind.reset();
+				RewindDict( mark );
+			}
+		}
+
+		void CancelDictRewind( void ) { fPendingDictRewind.reset(); }
+
+	private:
+
+		std::optional< DictMark >	fPendingDictRewind;
+
 	public:
 
+		WordListID NewWordList( Name name = "" )
+		{
+			fWordLists.emplace_back( WordDict(), std::move( name ), fDefLog.size() );
+			return fWordLists.size() - 1;
+		}
+
+		size_type GetNumOfWordLists( void ) const { return fWordLists.size(); }
+
+		WordDict & GetWordList( WordListID wid )
+		{
+			if( wid >= fWordLists.size() )
+				throw ForthError( "unknown wordlist" );
+			return fWordLists[ wid ].fDict;
+		}
+
+		const Name & GetWordListName( WordListID wid ) const
+		{
+			if( wid >= fWordLists.size() )
+				throw ForthError( "unknown wordlist" );
+			return fWordLists[ wid ].fName;
+		}
+
+		// The number of the definitions made before the wordlist was created
+		size_type GetWordListDefSeq( WordListID wid ) const
+		{
+			if( wid >= fWordLists.size() )
+				throw ForthError( "unknown wordlist" );
+			return fWordLists[ wid ].fDefSeq;
+		}
+
+
+		// Creates a new wordlist and its vocabulary word in the current wordlist,
+		// which replaces the top of the search order with the new wordlist
+		WordListID InsertVocabulary_2_Dict( Name name )
+		{
+			const auto wid { NewWordList( name ) };
+			InsertWord_2_Dict( name, MakeWord< VocabularyWord< TForthFor > >( * this, wid ), " -- " );
+			return wid;
+		}
+
+
+		WordListID	GetCurrent( void ) const { return fCurrent; }
+
+		void SetCurrent( WordListID wid )
+		{
+			GetWordList( wid );			// throws if wid is wrong
+			fCurrent = wid;
+		}
+
+
+		const SearchOrder & GetSearchOrder( void ) const { return fSearchOrder; }
+
+		WordListID GetSearchOrderTop( void ) const
+		{
+			WordListID wid {};
+			fSearchOrder.Peek( wid );
+			return wid;
+		}
+
+		// ALSO - duplicates the top wordlist
+		void Also( void )
+		{
+			if( ! fSearchOrder.Push( GetSearchOrderTop() ) )
+				throw ForthError( "search order overflow" );
+			DictChanged();
+		}
+
+		// PREVIOUS - removes the top wordlist (the last one is left)
+		void Previous( void )
+		{
+			if( fSearchOrder.size() <= 1 )
+				throw ForthError( "cannot remove the last wordlist from the search order" );
+			fSearchOrder.Truncate( fSearchOrder.size() - 1 );
+			DictChanged();
+		}
+
+		// ONLY - leaves only the FORTH wordlist (the ROOT one is searched anyway)
+		void Only( void )
+		{
+			fSearchOrder.clear();
+			fSearchOrder.Push( kForthWordList );
+			DictChanged();
+		}
+
+		void SetSearchOrderTop( WordListID wid )
+		{
+			GetWordList( wid );
+			fSearchOrder.data()[ fSearchOrder.size() - 1 ] = wid;
+			DictChanged();
+		}
+
+		// Puts wid just below the top wordlist, so the words of the top one still take precedence
+		void AddToSearchOrder( WordListID wid )
+		{
+			GetWordList( wid );
+			const auto top { GetSearchOrderTop() };
+			fSearchOrder.data()[ fSearchOrder.size() - 1 ] = wid;
+			if( ! fSearchOrder.Push( top ) )
+				throw ForthError( "search order overflow" );
+			DictChanged();
+		}
+
+
 		// Get the word's entry but the word can be not present
-		auto GetWordEntry( const Name & word_name )
+		// The wordlists are searched from the top of the search order, then the ROOT one
+		auto GetWordEntry( const std::string_view word_name )
 		{
+			const auto * order { fSearchOrder.data() };
+			for( auto i { fSearchOrder.size() }; i -- > 0; )
+				if( const auto word = fWordLists[ order[ i ] ].fDict.find( word_name ) )
+					return WordOptional( word );
 
-			if( const auto & word = fWordDict.find( word_name ); word != fWordDict.end() )
-				return WordOptional( & word->second );
+			if( const auto word = fWordLists[ kRootWordList ].fDict.find( word_name ) )
+				return WordOptional( word );
+
+			return WordOptional();
+		}
+
+		// As above, but only in the current wordlist
+		auto GetCurrentWordEntry( const std::string_view word_name )
+		{
+			if( const auto word = fWordLists[ fCurrent ].fDict.find( word_name ) )
+				return WordOptional( word );
 			else
 				return WordOptional();
 		}
@@ -151,21 +772,53 @@ namespace BCForth
 
 
 		// Returns true if a word was found and executed
-		virtual bool ExecWord( const Name & word_name )
+		virtual bool ExecWord( const std::string_view word_name )
 		{
 			auto word = GetWordEntry( word_name );
 			return word ? ( * ( (*word)->fWordUP ) )(), true : false;
 		}
 
 
-		virtual EIntCompBase ReadTheBase( void )
+	public:
+
+		// The system variables - these have fixed addresses, so the Forth words, such as BASE, just push 
+		// their addresses, whereas the C++ code reads them with a plain load
+		struct SystemVars
+		{
+			CellType	fBase { EIntCompBase::kDec };		// BASE - the radix of the number conversions
+			CellType	fState {};							// STATE - true while compiling
+			CellType	fToIn {};							// >IN - the number of the already consumed tokens of the current line
+		};
+
+		SystemVars &	GetSystemVars( void ) { return fSystemVars; }
+
+
+		// Any radix 2-36 can be set, out of this range BASE is treated as decimal
+		EIntCompBase ReadTheBase( void ) const
 		{
-			return EIntCompBase::kDec;		// in the base only this, will be extended in the interpreter
+			const auto base { fSystemVars.fBase };
+			return base >= kMinBase && base <= kMaxBase ? static_cast< EIntCompBase >( base ) : EIntCompBase::kDec;
 		}
 
+
+		// True if inside : ... ; which has not been closed yet
+		bool IsCompiling( void ) const { return fSystemVars.fState != 0; }
+
+	protected:
+
+		void SetCompiling( bool compiling ) { fSystemVars.fState = compiling ? kBoolTrue : kBoolFalse; }
+
+	private:
+
+		SystemVars		fSystemVars;
+
 	};
 
 
+	// The Forth of this build
+	using TForth = TForthFor< TForthPolicy >;
+
+
 
 
 }	// The end of the BCForth namespace
@@ -14,6 +14,9 @@
 
 
 #include "ForthInterpreter.h"
+#include "ForthImage.h"
+#include "SourceCache.h"
+#include "DictReclaimer.h"
 
 
 
@@ -38,13 +41,31 @@ namespace BCForth
 		Name	fCompiledWordName;
 		bool	fAllImmediate	{ false };	// used when processing [ ... ] in the compilation stage
 
+		TSourceCacheFor< TForthCompiler >	fSourceCache { * this };		// INCLUDE and REQUIRE
+
+		// Finding the garbage scans the whole dictionary, so it is done once per kReclaimBatch redefinitions (or when asked by RECLAIM)
+		static constexpr size_type	kReclaimBatch { 64 };
+
+		size_type	fReclaimedShadowings {};	// the number of the redefinitions at the last reclaiming of the garbage words
+		bool		fReclaimRequested { false };
+		size_type	fCallDepth {};				// the garbage is reclaimed only when no word is running
+
 		bool	fProcessingDefiningWord { false };		// when true, then a defining word is compiled, i.e. containing DOES>
 
+		Names	fLocalNames;			// names of the {: ... :} locals of the compiled word, in the order of their frame slots
+
+		bool	fOverwriteAllowed { true };	// false if the new word should not replace the existing one
+
 	protected:
 
 		using Base = TForthInterpreter;
 
-		using Base::fWordDict;
+	public:
+
+		using TForthInterpreter::TForthInterpreter;		// the stack capacities
+
+	protected:
+
 		using Base::fDataStack;
 		using Base::fRetStack;
 
@@ -57,7 +78,7 @@ namespace BCForth
 	protected:
 
 		// The plug-in for the Forth interpreter
-		void ProcessContextSequences( Names & ns ) override
+		void ProcessContextSequences( TokenCursor & ns ) override
 		{
 			const auto kNumNames { ns.size() };
 			if( kNumNames == 0 )
@@ -65,13 +86,21 @@ namespace BCForth
 
 			const auto & leadName { ns[ 0 ] };
 
+			// : NAME ... ; - the definition can be closed in this or in one of the next lines
+			if( leadName == Name( 1, kColon ) )
+			{
+				BeginWordDefinition( ns );
+				CompileWordDefinition( ns );
+				return;
+			}
+
 			// IMMEDIATE
 			if( leadName == "IMMEDIATE" )
 			{
 				// Let's find the lastly entered definition and mark it immediate
 				assert( fCompiledWordName.length() > 0 );
 
-				if( auto word = GetWordEntry( fCompiledWordName ) )
+				if( auto word = GetCurrentWordEntry( fCompiledWordName ) )
 					( * word )->fWordIsImmediate = true;
 				else
 					assert( false );
@@ -80,815 +109,710 @@ namespace BCForth
 				return;
 			}
 
-			// Call the base interpreter
-			Base::ProcessContextSequences( ns );
-		}
-
-
-		// Destructor will be created automatically virtual due to declaration in the base class
-
-	protected:
-
-
-		using CompoWordPtr = CompoWord< TForth > *;
-
-
-		using StructuralWordPtr = StructuralWord< TForth > * ;
-
-		static const size_type kStructuralStackSize { 64 };			// the max number of nested IF ... DO ...
-		using StructuralStack = TStackFor< StructuralWordPtr, kStructuralStackSize >;
-
-
-		StructuralStack		fStructuralStack;	// the stack to process structural constructions such as IF ... THEN
-
-
-	protected:
-
-
-
-		// theWord - collects the defining words
-		// ns - a list of words that will be consumed one after one
-		void Compile_StructuralWords_Into( CompoWord< TForth > & theWord, Names & ns )
-		{
-
-			const auto kNumTokens { ns.size() };
-			if( kNumTokens == 0 )
-				return;
-
-			const auto & token { ns[ 0 ] };
-
-
-
-			// IF ... ELSE ... THEN
-			// : TEST ( n -- )   DUP 0= IF DROP ELSE PROCESS THEN ;
-			if( token == "IF" )
+			// SAVE-IMAGE path - stores the words defined in Forth, so the program can start with them (--image path)
+			if( leadName == kSaveImage )
 			{
+				if( kNumNames <= 1 )
+					throw ForthError( "Syntax missing file name for " + leadName );
 
-				Erase_n_First_Words( ns, 1 );
-
-				// Create the IF node and insert to the current definition
-
-				auto if_node { std::make_unique< IF< TForth > >( * this ) };
-				auto if_node_ptr { if_node.get() };
-				theWord.AddWord( Insert_2_NodeRepo( std::move( if_node ) ) );
-
-				fStructuralStack.Push( & theWord );			// push the "current" node
-				fStructuralStack.Push( if_node_ptr );		// push this "IF" node
-
-				// Put its "TRUE" branch as the current insertion node
-				Compile_All_Into( if_node_ptr->GetTrueNode(), ns );
+				TForthImageFor< TForthCompiler >( * this ).Save( ns[ 1 ] );
 
+				Erase_n_First_Words( ns, 2 );
 				return;
 			}
 
-
-
-			// IF ... ELSE ... THEN
-			if( token == "ELSE" )
+			// INCLUDE path, REQUIRE path - compiles the file, or loads its words from the cache
+			if( leadName == kInclude || leadName == kRequire )
 			{
-				Erase_n_First_Words( ns, 1 );
+				if( kNumNames <= 1 )
+					throw ForthError( "Syntax missing file name for " + leadName );
 
-				// Just changed to the FALSE branch
-				if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Peek( struct_node_ptr ) )
-					if( auto * if_node_ptr = dynamic_cast< IF< TForth > * >( struct_node_ptr ) )
-						Compile_All_Into( if_node_ptr->GetFalseNode(), ns );
-					else
-						throw ForthError( "incorrectly interspersed structured IF - DO - LOOP" );
-				else
-					throw ForthError( "unbalanced IF - THEN structure" );
+				const Name path { ns[ 1 ] };
+				const bool require { leadName == kRequire };
+				Erase_n_First_Words( ns, 2 );
 
+				fSourceCache.Include( path, require );
 				return;
 			}
 
+			// Call the base interpreter
+			Base::ProcessContextSequences( ns );
+		}
 
-			// IF ... ELSE ... THEN
-			if( token == "THEN" )
-			{
-				Erase_n_First_Words( ns, 1 );
-
-				// Just remove the last IF node from the structural stack
-				if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-				{
-					if( ! dynamic_cast< IF< TForth > * >( struct_node_ptr ) )
-						throw ForthError( "incorrectly interspersed structured IF - DO - LOOP" );	
 
-					// Pop the previous "context"
-					if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-						if( CompoWordPtr compo_word_ptr = dynamic_cast< CompoWordPtr >( struct_node_ptr ) )
-							Compile_All_Into( * compo_word_ptr, ns );
-						else
-							throw ForthError( "incorrectly interspersed structured IF - DO - LOOP" );	
-					else
-						throw ForthError( "unbalanced IF - THEN structure" );
-
-				}
-				else
-				{
-					throw ForthError( "unbalanced IF - THEN structure" );
-				}
+	public:
 
+		auto & GetSourceCache( void ) { return fSourceCache; }
 
-				return;
+		// Called after the last line of a source - a definition still open there would swallow the next source
+		void CheckEndOfSource( const Name & source_name )
+		{
+			if( IsCompiling() )
+			{
+				CleanUpAfterRunTimeError();
+				throw ForthError( "unterminated definition in " + source_name );
 			}
+		}
 
+		// Destructor will be created automatically virtual due to declaration in the base class
 
+	protected:
 
 
+		using CompoWordPtr = CompoWord< TForth > *;
 
 
+		using StructuralWordPtr = StructuralWord< TForth > * ;
 
-			// DO ... LOOP
-			if( token == "DO" )
-			{
-				Erase_n_First_Words( ns, 1 );
-
-
-				auto do_node { std::make_unique< DO_LOOP< TForth > >( * this ) };
-				auto do_node_ptr { do_node.get() };
-				theWord.AddWord( Insert_2_NodeRepo( std::move( do_node ) ) );
+		// The kinds of the open structures - each tells the exact type of the node
+		enum class EStructKind : unsigned char { kIf, kDo, kBegin, kWhile, kCase, kOf };
 
-				fStructuralStack.Push( & theWord );			// push the "current" node
-				fStructuralStack.Push( do_node_ptr );		// push the "DO" node
+		struct StructuralEntry
+		{
+			EStructKind			fKind {};
+			StructuralWordPtr	fNode {};				// IF for kIf and kOf, DO_LOOP for kDo, BEGIN_LOOP for kBegin and kWhile, CASE for kCase
+			CompoWordPtr		fOuterContext {};		// the context to return to when the structure is closed
+		};
 
-				// Put its body branch as the current insertion node
-				Compile_All_Into( do_node_ptr->GetBodyNodes(), ns );
+		static const size_type kStructuralStackSize { 64 };			// the max number of nested IF ... DO ...
+		using StructuralStack = TStackFor< StructuralEntry, kStructuralStackSize >;
 
-				return;
-			}
 
+		StructuralStack		fStructuralStack;	// the stack to process structural constructions such as IF ... THEN
 
+		CompoWordPtr		fCompileContext { nullptr };	// where the words of the open definition go to (also when it continues in the next line)
 
-			// DO ... LOOP
-			if( token == "LOOP" || token == "+LOOP" )
-			{
+		WordEntry			fNewWordEntry;					// the word being compiled, entered to the dictionary at its ;
 
-				// Compile the extra "+1" literal node as the step value
-				if( token[ 0 ] != kPlus )
-					theWord.AddWord( Insert_2_NodeRepo( std::make_unique< IntValWord< TForth > >( * this, +1 ) ) );
 
-				Erase_n_First_Words( ns, 1 );		// get rid of the token
+		// Returns a frame slot if n is a local of the currently compiled word
+		std::optional< size_type > FindLocal( const Name & n ) const
+		{
+			if( auto pos = std::find( fLocalNames.begin(), fLocalNames.end(), n ); pos != fLocalNames.end() )
+				return static_cast< size_type >( pos - fLocalNames.begin() );
+			else
+				return std::nullopt;
+		}
 
 
-				// Just remove the last DO node from the structural stack
-				if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-				{
-					if( ! dynamic_cast< DO_LOOP< TForth > * >( struct_node_ptr ) )
-						throw ForthError( "incorrectly interspersed structured IF - DO - LOOP" );	
+	protected:
 
-					// Pop the previous "context"
-					if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-						if( CompoWordPtr compo_word_ptr = dynamic_cast< CompoWordPtr >( struct_node_ptr ) )
-							Compile_All_Into( * compo_word_ptr, ns );
-						else
-							throw ForthError( "incorrectly interspersed structured IF - DO - LOOP" );	
-					else
-						throw ForthError( "unbalanced IF - THEN structure" );
 
-				}
-				else
-				{
-					throw ForthError( "unbalanced DO - LOOP structure" );
-				}
 
-				return;
-			}
+		// The words processed by the compiler itself, rather than found in the dictionary
+		enum class EKeyword { kNone, kSemColon, kIf, kElse, kThen, kDo, kLoop, kPlusLoop, kI, kJ, kBegin, kAgain, kUntil, kWhile, kRepeat, kExit, 
+								kCase, kOf, kEndOf, kEndCase, kLocals, kTo, kBracketTick, kLeftBracket, kRightBracket, kPostpone, kLiteral, 
+								kDoes, kBracketChar, kDotQuote, kCQuote, kSQuote, kAbortQuote, kLeftParen };
 
+		// One hash lookup per token instead of the chain of comparisons
+		static EKeyword FindKeyword( const Name & token )
+		{
+			static const std::unordered_map< Name, EKeyword > kKeywords {
+				{ Name( 1, kSemColon ), EKeyword::kSemColon },
+				{ "IF", EKeyword::kIf }, { "ELSE", EKeyword::kElse }, { "THEN", EKeyword::kThen },
+				{ "DO", EKeyword::kDo }, { "LOOP", EKeyword::kLoop }, { "+LOOP", EKeyword::kPlusLoop }, { "I", EKeyword::kI }, { "J", EKeyword::kJ },
+				{ "BEGIN", EKeyword::kBegin }, { "AGAIN", EKeyword::kAgain }, { "UNTIL", EKeyword::kUntil }, { "WHILE", EKeyword::kWhile }, { "REPEAT", EKeyword::kRepeat }, { "EXIT", EKeyword::kExit },
+				{ "CASE", EKeyword::kCase }, { "OF", EKeyword::kOf }, { "ENDOF", EKeyword::kEndOf }, { "ENDCASE", EKeyword::kEndCase },
+				{ "{:", EKeyword::kLocals }, { "TO", EKeyword::kTo }, { "[']", EKeyword::kBracketTick }, { "[", EKeyword::kLeftBracket }, { "]", EKeyword::kRightBracket },
+				{ "POSTPONE", EKeyword::kPostpone }, { "LITERAL", EKeyword::kLiteral }, { "DOES>", EKeyword::kDoes }, { "[CHAR]", EKeyword::kBracketChar },
+				{ kDotQuote, EKeyword::kDotQuote }, { kCQuote, EKeyword::kCQuote }, { kSQuote, EKeyword::kSQuote }, { kAbortQuote, EKeyword::kAbortQuote },
+				{ Name( 1, kLeftParen ), EKeyword::kLeftParen } 
+			};
+
+			const auto pos { kKeywords.find( token ) };
+			return pos != kKeywords.end() ? pos->second : EKeyword::kNone;
+		}
 
 
-			// I 
-			if( token == "I" || token == "J" )
-			{
-				auto skipCounter { token[ 0 ] - 'I' };		// "I" is 0, "J" is 1 (outeremost loop index)
-				
-				Erase_n_First_Words( ns, 1 );
 
-				// Find a DO node and connect with the new I_LOOP node
+		// Opens a new structure - its node is added to the current context, and the context is saved in the structural stack
+		template < typename Node >
+		Node & OpenStructure( const EStructKind kind, std::unique_ptr< Node > node )
+		{
+			auto & node_ref { * node };
+			fCompileContext->AddWord( Insert_2_NodeRepo( std::move( node ) ) );
 
-				auto struct_stack { fStructuralStack.data() };
+			if( fStructuralStack.Push( { kind, & node_ref, fCompileContext } ) == false )
+				throw ForthError( "too deeply nested structures" );
 
-				for( auto i { fStructuralStack.size() }; i > 0; -- i )
-				{
-					if( const auto * do_node = dynamic_cast< DO_LOOP< TForth > * >( fStructuralStack.data()[ i - 1 ] ) )
-					{
-						// Found, ok
-						if( skipCounter -- > 0 )
-							continue;							// go and search deeper in the stack
+			return node_ref;
+		}
 
-						theWord.AddWord( Insert_2_NodeRepo( std::make_unique< I_LOOP< TForth > >( * this, * do_node ) ) );
-						Compile_All_Into( theWord, ns );		// process the same compound word
+		// Returns the innermost structure which must be of the kind
+		template < typename Node >
+		Node & PeekStructure( const EStructKind kind, const Name & structure_name )
+		{
+			StructuralEntry entry {};
+			if( fStructuralStack.Peek( entry ) == false )
+				throw ForthError( "unbalanced " + structure_name + " structure" );
 
-						return;
-					}
-				}
+			if( entry.fKind != kind )
+				throw ForthError( "incorrectly interspersed structured " + structure_name );
 
-				throw ForthError( " loop index I used in wrong context" );
-			}
+			return * static_cast< Node * >( entry.fNode );
+		}
 
+		// Closes the innermost structure which must be of the kind - its outer context becomes the current one
+		template < typename Node >
+		Node & CloseStructure( const EStructKind kind, const Name & structure_name )
+		{
+			auto & node { PeekStructure< Node >( kind, structure_name ) };
 
+			StructuralEntry entry {};
+			fStructuralStack.Pop( entry );
+			fCompileContext = entry.fOuterContext;
 
-			// ==========================================
-			// There are 3 structures starting with BEGIN
-			// 
-			// BEGIN ... S ... AGAIN		( indefinite )
-			// BEGIN ... S ..v UNTIL		( iterate as long as v is FALSE )
-			// BEGIN ... SA ...v WHILE ... SB ... REPEAT ( WHILE checks v, if FALSE, then exit the loop; otherwise REPEAT jumps to BEGIN )
-			//
-			if( token == "BEGIN" )
-			{
-				Erase_n_First_Words( ns, 1 );
+			return node;
+		}
 
+		// Finds the n-th innermost open structure of any of the two kinds (going outwards), or returns nullptr
+		StructuralWordPtr FindOpenStructure( const EStructKind kind_a, const EStructKind kind_b, size_type n = 0 )
+		{
+			for( auto i { fStructuralStack.size() }; i > 0; -- i )
+				if( const auto & entry { fStructuralStack.data()[ i - 1 ] }; ( entry.fKind == kind_a || entry.fKind == kind_b ) && n -- == 0 )
+					return entry.fNode;
 
-				auto do_node { std::make_unique< BEGIN_LOOP< TForth > >( * this ) };
-				auto do_node_ptr { do_node.get() };
-				theWord.AddWord( Insert_2_NodeRepo( std::move( do_node ) ) );
+			return nullptr;
+		}
 
-				fStructuralStack.Push( & theWord );			// push the "current" node
-				fStructuralStack.Push( do_node_ptr );		// push the "BEGIN" node
 
-				// Put its body branch as the current insertion node
-				Compile_All_Into( do_node_ptr->Get_Begin_Nodes(), ns );
 
-				return;
-			}
+		// Compiles ns[ 0 ] (together with its arguments, if any) into the current context.
+		// The structural words just change the context, so a definition is compiled in a simple loop.
+		void CompileToken( TokenCursor & ns )
+		{
+			assert( ns.size() > 0 && fCompileContext != nullptr );
 
+			auto & theWord { * fCompileContext };
 
+			const auto & token { ns[ 0 ] };
 
-			if( token == "AGAIN" )
+			switch( const auto keyword { FindKeyword( token ) }; keyword )
 			{
-				Erase_n_First_Words( ns, 1 );
-
-				// Just remove the last BEGIN node from the structural stack
-				if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-				{
-					if( auto begin_node = dynamic_cast< BEGIN_LOOP< TForth > * >( struct_node_ptr ) )
-						begin_node->SetLoopType( BEGIN_LOOP< TForth >::EBeginLoopType::kAgain );
-					else
-						throw ForthError( "incorrectly interspersed structured BEGIN - AGAIN" );	
-
-
-					// Pop the previous "context"
-					if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-						if( CompoWordPtr compo_word_ptr = dynamic_cast< CompoWordPtr >( struct_node_ptr ) )
-							Compile_All_Into( * compo_word_ptr, ns );
-						else
-							throw ForthError( "incorrectly interspersed structured BEGIN - AGAIN" );	
-					else
-						throw ForthError( "unbalanced BEGIN - AGAIN structure" );
-
-				}
-				else
-				{
-					throw ForthError( "unbalanced BEGIN - AGAIN structure" );
-				}
+				// The end of the definition - the rest of ns is left for the interpreter
+				case EKeyword::kSemColon:
+					SetCompiling( false );
+					break;
 
-				return;
-			}
 
+				// IF ... ELSE ... THEN
+				// : TEST ( n -- )   DUP 0= IF DROP ELSE PROCESS THEN ;
+				case EKeyword::kIf:
+					// Put its "TRUE" branch as the current insertion node
+					fCompileContext = & OpenStructure( EStructKind::kIf, MakeWord< IF< TForth > >( * this ) ).GetTrueNode();
+					break;
 
-			if( token == "UNTIL" )
-			{
-				Erase_n_First_Words( ns, 1 );
+				case EKeyword::kElse:
+					// Just changed to the FALSE branch
+					fCompileContext = & PeekStructure< IF< TForth > >( EStructKind::kIf, "IF - THEN" ).GetFalseNode();
+					break;
 
-				// Just remove the last BEGIN node from the structural stack
-				if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-				{
-					if( auto begin_node = dynamic_cast< BEGIN_LOOP< TForth > * >( struct_node_ptr ) )
-						begin_node->SetLoopType( BEGIN_LOOP< TForth >::EBeginLoopType::kUntil );
-					else
-						throw ForthError( "incorrectly interspersed structured BEGIN - UNTIL" );	
+				case EKeyword::kThen:
+					CloseStructure< IF< TForth > >( EStructKind::kIf, "IF - THEN" );
+					break;
 
 
-					// Pop the previous "context"
-					if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-						if( CompoWordPtr compo_word_ptr = dynamic_cast< CompoWordPtr >( struct_node_ptr ) )
-							Compile_All_Into( * compo_word_ptr, ns );
-						else
-							throw ForthError( "incorrectly interspersed structured BEGIN - UNTIL" );	
-					else
-						throw ForthError( "unbalanced BEGIN - UNTIL structure" );
+				// DO ... LOOP
+				case EKeyword::kDo:
+					// Put its body branch as the current insertion node
+					fCompileContext = & OpenStructure( EStructKind::kDo, MakeWord< DO_LOOP< TForth > >( * this ) ).GetBodyNodes();
+					break;
 
-				}
-				else
-				{
-					throw ForthError( "unbalanced BEGIN - UNTIL structure" );
-				}
+				case EKeyword::kLoop:
+					// Compile the extra "+1" literal node as the step value
+					theWord.AddWord( Insert_2_NodeRepo( MakeWord< IntValWord< TForth > >( * this, +1 ) ) );
+					CloseStructure< DO_LOOP< TForth > >( EStructKind::kDo, "DO - LOOP" );
+					break;
 
-				return;
-			}
-
-
-			if( token == "WHILE" )
-			{
-				Erase_n_First_Words( ns, 1 );
+				case EKeyword::kPlusLoop:
+					CloseStructure< DO_LOOP< TForth > >( EStructKind::kDo, "DO - LOOP" );
+					break;
 
-				// Just remove the last BEGIN node from the structural stack
-				if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-				{
-					if( auto begin_node = dynamic_cast< BEGIN_LOOP< TForth > * >( struct_node_ptr ) )
-					{
-						begin_node->SetLoopType( BEGIN_LOOP< TForth >::EBeginLoopType::kWhileRepeat );
-						Compile_All_Into( begin_node->Get_While_Nodes(), ns );		// work out the WHILE ... REPEAT branch
-					}
+				case EKeyword::kI:
+				case EKeyword::kJ:
+					// "I" is the innermost loop index, "J" is the index of the next outer loop
+					if( auto * do_node = FindOpenStructure( EStructKind::kDo, EStructKind::kDo, token == "I" ? 0 : 1 ) )
+						theWord.AddWord( Insert_2_NodeRepo( MakeWord< I_LOOP< TForth > >( * this, * static_cast< DO_LOOP< TForth > * >( do_node ) ) ) );
 					else
+						throw ForthError( " loop index I used in wrong context" );
+					break;
+
+
+				// ==========================================
+				// There are 3 structures starting with BEGIN
+				// 
+				// BEGIN ... S ... AGAIN		( indefinite )
+				// BEGIN ... S ..v UNTIL		( iterate as long as v is FALSE )
+				// BEGIN ... SA ...v WHILE ... SB ... REPEAT ( WHILE checks v, if FALSE, then exit the loop; otherwise REPEAT jumps to BEGIN )
+				//
+				case EKeyword::kBegin:
+					// Put its body branch as the current insertion node
+					fCompileContext = & OpenStructure( EStructKind::kBegin, MakeWord< BEGIN_LOOP< TForth > >( * this ) ).Get_Begin_Nodes();
+					break;
+
+				case EKeyword::kAgain:
+					CloseStructure< BEGIN_LOOP< TForth > >( EStructKind::kBegin, "BEGIN - AGAIN" ).SetLoopType( BEGIN_LOOP< TForth >::EBeginLoopType::kAgain );
+					break;
+
+				case EKeyword::kUntil:
+					CloseStructure< BEGIN_LOOP< TForth > >( EStructKind::kBegin, "BEGIN - UNTIL" ).SetLoopType( BEGIN_LOOP< TForth >::EBeginLoopType::kUntil );
+					break;
+
+				case EKeyword::kWhile:
 					{
-						throw ForthError( "incorrectly interspersed structured BEGIN - WHILE" );	
-					}
-				}
-				else
-				{
-					throw ForthError( "unbalanced BEGIN - WHILE structure" );
-				}
-
-				return;
-			}
+						// The BEGIN stays open, but from now on it can be closed only with REPEAT
+						auto & begin_node { PeekStructure< BEGIN_LOOP< TForth > >( EStructKind::kBegin, "BEGIN - WHILE" ) };
+						begin_node.SetLoopType( BEGIN_LOOP< TForth >::EBeginLoopType::kWhileRepeat );
+						fStructuralStack.data()[ fStructuralStack.size() - 1 ].fKind = EStructKind::kWhile;
 
+						fCompileContext = & begin_node.Get_While_Nodes();		// work out the WHILE ... REPEAT branch
+					}
+					break;
 
-			if( token == "REPEAT" )
-			{
-				Erase_n_First_Words( ns, 1 );
+				case EKeyword::kRepeat:
+					CloseStructure< BEGIN_LOOP< TForth > >( EStructKind::kWhile, "BEGIN - WHILE - REPEAT" );
+					break;
 
-				// Pop the previous "context"
-				if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-					if( CompoWordPtr compo_word_ptr = dynamic_cast< CompoWordPtr >( struct_node_ptr ) )
-						Compile_All_Into( * compo_word_ptr, ns );
+				case EKeyword::kExit:
+					// Find the closest BEGIN node and connect with the EXIT_BEGIN_LOOP
+					if( auto * begin_node = FindOpenStructure( EStructKind::kBegin, EStructKind::kWhile ) )
+						theWord.AddWord( Insert_2_NodeRepo( MakeWord< EXIT_BEGIN_LOOP< TForth > >( * this, * static_cast< BEGIN_LOOP< TForth > * >( begin_node ) ) ) );
 					else
-						throw ForthError( "incorrectly interspersed structured BEGIN - WHILE - REPEAT" );	
-				else
-					throw ForthError( "unbalanced BEGIN - WHILE - REPEAT structure" );
-
-				return;
-			}
-
-
-
-			if( token == "EXIT" )
-			{
-				Erase_n_First_Words( ns, 1 );
-
-				// Find the closest BEGIN node and connect with the EXIT_BEGIN_LOOP
-
-				for( auto i { fStructuralStack.size() }; i > 0; -- i )
-				{
-					if( auto * do_node = dynamic_cast< BEGIN_LOOP< TForth > * >( fStructuralStack.data()[ i - 1 ] ) )
+						throw ForthError( " EXIT word used without BEGIN" );
+					break;
+
+
+				// ==========================================
+
+				// CASE ... ENDCASE
+				// an example
+				// : TEST CASE ." chosen: "
+				//			0 OF  ." no"  ENDOF
+				//			1 OF  ." one" ENDOF
+				//			2 OF  ." two" CR .F CR .F CR ENDOF
+				//			DUP .			\ show it before it vanishes
+				//		ENDCASE ;
+				// CASE will be transformed into the nested IF ... ELSE ... THEN
+				case EKeyword::kCase:
+					fCompileContext = & OpenStructure( EStructKind::kCase, MakeWord< CASE< TForth > >( * this ) );	// from now on operate in the context of CASE
+					break;
+
+				case EKeyword::kOf:
 					{
-						// Found, ok
-						theWord.AddWord( Insert_2_NodeRepo( std::make_unique< EXIT_BEGIN_LOOP< TForth > >( * this, * do_node ) ) );
-						Compile_All_Into( theWord, ns );		// process the same compound word
-
-						return;
-					}
-				}
-
-				throw ForthError( " EXIT word used without BEGIN" );
-			}
-
-
-			// ==========================================
-
-			// CASE ... ENDCASE
-			// an example
-			// : TEST CASE ." chosen: "
-			//			0 OF  ." no"  ENDOF
-			//			1 OF  ." one" ENDOF
-			//			2 OF  ." two" CR .F CR .F CR ENDOF
-			//			DUP .			\ show it before it vanishes
-			//		ENDCASE ;
-			// CASE will be transformed into the nested IF ... ELSE ... THEN
-			if( token == "CASE" )
-			{
-				// Actually do nothing - the real actions take place after encountering OF
-				Erase_n_First_Words( ns, 1 );
-
-				fStructuralStack.Push( & theWord );			// push the "current" context
+						// Before the IF node insert OVER =
+						assert( GetWordEntry( "OVER" ) );
+						theWord.AddWord( ( * GetWordEntry( "OVER" ) )->fWordUP.get() );
 
+						assert( GetWordEntry( "=" ) );
+						theWord.AddWord( ( * GetWordEntry( "=" ) )->fWordUP.get() );
 
-				auto case_node { std::make_unique< CASE< TForth > >( * this ) };
-				auto case_node_ptr { case_node.get() };
-				theWord.AddWord( Insert_2_NodeRepo( std::move( case_node ) ) );
+						auto & if_node { OpenStructure( EStructKind::kOf, MakeWord< IF< TForth > >( * this ) ) };
 
-				fStructuralStack.Push( case_node_ptr );		// push this "CASE" node
-
-				Compile_All_Into( * case_node_ptr, ns );	// from now on operate in the context of CASE
-
-				return;
-			}
+						assert( GetWordEntry( "DROP" ) );
+						if_node.GetTrueNode().AddWord( ( * GetWordEntry( "DROP" ) )->fWordUP.get() );
 
-			if( token == "OF" )
-			{
-				Erase_n_First_Words( ns, 1 );
+						// Put its "TRUE" branch as the current insertion node
+						fCompileContext = & if_node.GetTrueNode();
+					}
+					break;
 
-				// Before the IF node insert OVER =
-				// CHANGE - these words should be already in the dictionary, so find them and isert calls to them 
-				assert( GetWordEntry( "OVER" ) );
-				theWord.AddWord( ( * GetWordEntry( "OVER" ) )->fWordUP.get() );
+				case EKeyword::kEndOf:
+					// Acts as ELSE
+					fCompileContext = & PeekStructure< IF< TForth > >( EStructKind::kOf, "OF - ENDOF" ).GetFalseNode();
+					break;
 
-				assert( GetWordEntry( "=" ) );
-				theWord.AddWord( ( * GetWordEntry( "=" ) )->fWordUP.get() );
+				case EKeyword::kEndCase:
+					{
+						// The last is DROP to get rid of the untaken value - it goes to the FALSE branch of the newest OF
+						auto & last_if_node { PeekStructure< IF< TForth > >( EStructKind::kOf, "CASE ... ENDCASE" ) };
+						assert( GetWordEntry( "DROP" ) );
+						last_if_node.GetFalseNode().AddWord( ( * GetWordEntry( "DROP" ) )->fWordUP.get() );
 
+						// Dig out all the OF structures up to CASE
+						for( StructuralEntry entry {}; fStructuralStack.Peek( entry ) && entry.fKind == EStructKind::kOf; fStructuralStack.Pop( entry ) )
+							;
 
+						CloseStructure< CASE< TForth > >( EStructKind::kCase, "CASE ... ENDCASE" );
+					}
+					break;
 
-				// Create the IF node and insert to the current definition
-				auto if_node { std::make_unique< IF< TForth > >( * this ) };
-				auto if_node_ptr { if_node.get() };
-				theWord.AddWord( Insert_2_NodeRepo( std::move( if_node ) ) );
 
-				fStructuralStack.Push( if_node_ptr );		// push this "IF" node
+				// {: a b | c -- d :}
+				// Declare the locals - the arguments a b are taken from the data stack, 
+				// c is an uninitialized local, whereas all after -- up to :} is a comment
+				case EKeyword::kLocals:
+					{
+						if( fStructuralStack.size() != 0 )
+							throw ForthError( " locals cannot be declared inside control structures" );
 
+						if( fLocalNames.size() != 0 )
+							throw ForthError( " only one {: ... :} declaration allowed in a word definition" );
 
-				assert( GetWordEntry( "DROP" ) );
-				if_node_ptr->GetTrueNode().AddWord( ( * GetWordEntry( "DROP" ) )->fWordUP.get() );
+						size_type num_args {};
+						for( bool args_mode { true }, comment_mode { false }; ; )
+						{
+							Erase_n_First_Words( ns, 1 );		// the {: at first, then the consecutive locals
 
-				// Put its "TRUE" branch as the current insertion node
-				Compile_All_Into( if_node_ptr->GetTrueNode(), ns );
+							if( ns.size() == 0 )
+								throw ForthError( " no closing :} found for the opening {:" );
 
-				return;
+							const auto & local_name { ns[ 0 ] };
 
-			}
+							if( local_name == ":}" )
+								break;
 
+							if( local_name == "--" )
+								comment_mode = true;
 
-			// Acts as ELSE
-			if( token == "ENDOF" )
-			{
-				Erase_n_First_Words( ns, 1 );
+							if( comment_mode )
+								continue;
 
-				// Just changed to the FALSE branch
-				if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Peek( struct_node_ptr ) )
-					if( auto * if_node_ptr = dynamic_cast< IF< TForth > * >( struct_node_ptr ) )
-						Compile_All_Into( if_node_ptr->GetFalseNode(), ns );
-					else
-						throw ForthError( "incorrectly interspersed structured OF - ENDOF" );
-				else
-					throw ForthError( "unbalanced IF - THEN structure" );
-
-
-				return;
-			}
+							if( local_name == "|" )
+							{
+								args_mode = false;
+								continue;
+							}
 
+							if( FindLocal( local_name ) )
+								throw ForthError( " local " + local_name + " declared twice" );
 
+							fLocalNames.push_back( local_name );
+							num_args += args_mode ? 1 : 0;
+						}
 
-			// ENDCASE needs to un-wind the fStructuralStack up to the nearest CASE node
-			if( token == "ENDCASE" )
-			{
-				Erase_n_First_Words( ns, 1 );
+						auto frame_node { MakeWord< LOCALS_FRAME< TForth > >( * this, num_args, fLocalNames.size() ) };
+						auto frame_node_ptr { frame_node.get() };
+						theWord.AddWord( Insert_2_NodeRepo( std::move( frame_node ) ) );
 
+						// All the remaining words go to the frame's body
+						fCompileContext = & frame_node_ptr->GetBodyNodes();
+					}
+					break;
 
 
-				// bug fix - we don't need this DROP since it is already done by the last IF in the chain
-				// Add DROP to the last (the newest on the stack) IF ... ELSE < we are here > THEN
-				if( StructuralWordPtr struct_node_ptr {}; fStructuralStack.Pop( struct_node_ptr ) )
-				{
-					if( auto last_if_branch = dynamic_cast< IF< TForth > * >( struct_node_ptr ) )
+				// TO name - store to a local, or to a VALUE
+				case EKeyword::kTo:
 					{
-						assert( GetWordEntry( "DROP" ) );		// the last is DROP to get rid of the untaken value
-						last_if_branch->GetFalseNode().AddWord( ( * GetWordEntry( "DROP" ) )->fWordUP.get() );
+						if( ns.size() <= 1 )
+							throw ForthError( "Syntax TO should be followed by a local or a VALUE name" );
 
+						const auto & value_name { ns[ 1 ] };
 
-						// Dig out all the remaining IF ... ELSE ... THEN structures up to CASE
-						for( auto node_ptr { StructuralStack::value_type() }; fStructuralStack.Pop( node_ptr ); )
+						if( const auto slot = FindLocal( value_name ) )
 						{
-							if( dynamic_cast< CASE< TForth > * >( node_ptr ) && fStructuralStack.Pop( node_ptr ) )	// got the CASE, so immediately get next node (previous context)
-							{
-								if( auto comp_node_ptr = dynamic_cast< CompoWord< TForth > * >( node_ptr ) )
-								{
-									Compile_All_Into( * comp_node_ptr, ns );
-									return;
-								}
-								else
-								{
-									assert( false );
-								}
-
-							}
+							theWord.AddWord( Insert_2_NodeRepo( MakeWord< LocalStore< TForth > >( * this, * slot ) ) );
+						}
+						else
+						{
+							// A VALUE is a CREATEd array of one cell, so compile in its address followed by !
+							auto value_entry { GetWordEntry( value_name ) };
+							auto * compo_wrd = value_entry && ( * value_entry )->fWordIsValue ? dynamic_cast< CompoWordPtr >( ( * value_entry )->fWordUP.get() ) : nullptr;
+							auto * val_array = compo_wrd && compo_wrd->GetWordsVec().size() > 0 ? dynamic_cast< RawByteArray< TForth > * >( compo_wrd->GetWordsVec()[ 0 ] ) : nullptr;
+							if( val_array == nullptr || val_array->GetData().size() != sizeof( CellType ) )
+								throw ForthError( " TO used with " + value_name + " which is neither a local nor a VALUE" );
+
+							theWord.AddWord( Insert_2_NodeRepo( MakeWord< CellValWord< TForth > >( * this, reinterpret_cast< CellType >( val_array->GetData().data() ) ) ) );
+							assert( GetWordEntry( "!" ) );
+							theWord.AddWord( ( * GetWordEntry( "!" ) )->fWordUP.get() );
 						}
 
+						Erase_n_First_Words( ns, 1 );		// get rid of the name, TO is removed below
 					}
-
-				}
+					break;
 
 
+				// Compile-in word's execution token (i.e. the address of the Word object to execute its operato())
+				case EKeyword::kBracketTick:
+					// The same action as for the LITERAL but with the word's pointer 
+					if( ns.size() <= 1 )
+						throw ForthError( "Syntax ['] should be followed by a word name" );
 
-				throw ForthError( " unbalanced CASE ... ENDCASE" );
-			}
-
-
-
-			// Compile-in word's execution token (i.e. the address of the Word object to execute its operato())
-			if( token == "[']" )
-			{
-				// The same action as for the LITERAL but with the word's pointer 
-				if( const auto word_entry_ptr = GetWordEntry( ns[ 1 ] ) )
-					theWord.AddWord( Insert_2_NodeRepo( std::make_unique< CellValWord< TForth > >( * this, reinterpret_cast< CellType >( ( * word_entry_ptr )->fWordUP.get() ) ) ) );
-				else
-					throw ForthError( " unknown word " + ns[ 1 ] + " following [']" );
-
-				Erase_n_First_Words( ns, 2 );		// get rid of the two tokenn
-				return;
-			}
-
-
-
-
-			// ==========================================
-
-			// Process immediate words
-			if( token == "[" )
-			{
-				fAllImmediate = true;
-				Erase_n_First_Words( ns, 1 );		// get rid of the token
-				return;
-			}
-
-
-			if( token == "]" )
-			{
-				fAllImmediate = false;
-				Erase_n_First_Words( ns, 1 );		// get rid of the token
-				Compile_All_Into( theWord, ns );	// return to the compile mode
-				return;
-			}
-
-
-			if( token == "POSTPONE" )
-			{
-				if( ns.size() <= 1 )
-					throw ForthError( "Syntax  POSTPONE should be followed by a word" );
+					if( const auto word_entry_ptr = GetWordEntry( ns[ 1 ] ) )
+						theWord.AddWord( Insert_2_NodeRepo( MakeWord< CellValWord< TForth > >( * this, reinterpret_cast< CellType >( ( * word_entry_ptr )->fWordUP.get() ) ) ) );
+					else
+						throw ForthError( " unknown word " + ns[ 1 ] + " following [']" );
 
+					Erase_n_First_Words( ns, 1 );		// get rid of the name, ['] is removed below
+					break;
 
-				if( const auto word_entry_ptr = GetWordEntry( ns[ 1 ] ) )
-					theWord.AddWord( Insert_2_NodeRepo( std::make_unique< Postpone< TForth > >( * this, ( * word_entry_ptr )->fWordUP.get() ) ) );
-				else
-					throw ForthError( " unknown word " + ns[ 1 ] + " following POSTPONE" );
 
+				// ==========================================
 
-				Erase_n_First_Words( ns, 2 );		// get rid of the token
-				Compile_All_Into( theWord, ns );	// return to the compile mode
-				return;
-			}
+				// Process immediate words
+				case EKeyword::kLeftBracket:
+					fAllImmediate = true;
+					break;
 
+				case EKeyword::kRightBracket:
+					fAllImmediate = false;
+					break;
 
 
-			if( token == "LITERAL" )
-			{
-				if( typename DataStack::value_type t {}; GetDataStack().Pop( t ) )
-					theWord.AddWord( Insert_2_NodeRepo( std::make_unique< CellValWord< TForth > >( * this, t ) ) );
-				else
-					throw ForthError( "unexpectedly empty stack" );
+				case EKeyword::kPostpone:
+					if( ns.size() <= 1 )
+						throw ForthError( "Syntax  POSTPONE should be followed by a word" );
 
-				Erase_n_First_Words( ns, 1 );		// get rid of the token
-				return;		
-			}
+					if( const auto word_entry_ptr = GetWordEntry( ns[ 1 ] ) )
+						theWord.AddWord( Insert_2_NodeRepo( MakeWord< Postpone< TForth > >( * this, ( * word_entry_ptr )->fWordUP.get() ) ) );
+					else
+						throw ForthError( " unknown word " + ns[ 1 ] + " following POSTPONE" );
 
+					Erase_n_First_Words( ns, 1 );		// get rid of the name, POSTPONE is removed below
+					break;
 
-			if( token == "DOES>" )
-			{
 
-				// When DOES> is encountered then the following needs to be done:
-				// - the DOES> node needs to be created
-				// - its creational branch is copied from the currently collected words of "theWord"
-				// - its behavioral branch becomes the current context
-				// - the creational branch must contain the CREATE word (otherwise syntax error)
+				case EKeyword::kLiteral:
+					if( typename DataStack::value_type t {}; GetDataStack().Pop( t ) )
+						theWord.AddWord( Insert_2_NodeRepo( MakeWord< CellValWord< TForth > >( * this, t ) ) );
+					else
+						throw ForthError( "unexpectedly empty stack" );
+					break;
 
 
-				Erase_n_First_Words( ns, 1 );		// get rid of the "DOES>" token
+				case EKeyword::kDoes:
+					{
+						// When DOES> is encountered then the following needs to be done:
+						// - the DOES> node needs to be created
+						// - its creational branch is copied from the currently collected words of "theWord"
+						// - its behavioral branch becomes the current context
+						// - the creational branch must contain the CREATE word (otherwise syntax error)
 
-				assert( fProcessingDefiningWord == false );
-				if( fProcessingDefiningWord == true )
-					throw ForthError( " word definition can contain only one DOES>" );
+						assert( fProcessingDefiningWord == false );
+						if( fProcessingDefiningWord == true )
+							throw ForthError( " word definition can contain only one DOES>" );
 
-				fProcessingDefiningWord = true;
+						fProcessingDefiningWord = true;
 
-				auto does_node { std::make_unique< DOES< TForth > >( * this ) };
-				auto does_node_ptr { does_node.get() };
-				assert( does_node_ptr );
+						if( fLocalNames.size() != 0 )
+							throw ForthError( " locals of the creational branch cannot span DOES>" );
 
-				does_node_ptr->GetCreationNode().GetWordsVec() = theWord.GetWordsVec();		// copy whatever has been already collected in theWord
-				theWord.GetWordsVec().clear();
-				theWord.AddWord( Insert_2_NodeRepo( std::move( does_node ) ) );				// from now on, execution of theWord will launch exclusively action of the DOES node
+						auto does_node { MakeWord< DOES< TForth > >( * this ) };
+						auto does_node_ptr { does_node.get() };
+						assert( does_node_ptr );
 
-				// Switch off the current context to the behavioral branch of the DOES node
-				Compile_All_Into( does_node_ptr->GetBehaviorNode(), ns );					// return to the compile mode
-
-				return;
-			}
+						does_node_ptr->GetCreationNode().GetWordsVec() = theWord.GetWordsVec();		// copy whatever has been already collected in theWord
+						theWord.GetWordsVec().clear();
+						theWord.AddWord( Insert_2_NodeRepo( std::move( does_node ) ) );				// from now on, execution of theWord will launch exclusively action of the DOES node
 
+						// Switch off the current context to the behavioral branch of the DOES node
+						fCompileContext = & does_node_ptr->GetBehaviorNode();
+					}
+					break;
 
-			// (bracket-care) take the following word/char and compile its ASCII value
-			if( token == "[CHAR]" )
-			{
-				if( ns.size() <= 1 )
-					throw ForthError( "Syntax  [CHAR] should be followed by a text" );
 
-				theWord.AddWord( Insert_2_NodeRepo( std::make_unique< CharValWord< TForth > >( * this, BlindValueReInterpretation< Char >( ns[ 1 ][ 0 ] ) ) ) );
+				// (bracket-care) take the following word/char and compile its ASCII value
+				case EKeyword::kBracketChar:
+					if( ns.size() <= 1 )
+						throw ForthError( "Syntax  [CHAR] should be followed by a text" );
 
-				Erase_n_First_Words( ns, 2 );		// get rid of the tokens
-				Compile_All_Into( theWord, ns );	// return to the compile mode
-				return;		
-			}
+					theWord.AddWord( Insert_2_NodeRepo( MakeWord< CharValWord< TForth > >( * this, BlindValueReInterpretation< Char >( ns[ 1 ][ 0 ] ) ) ) );
 
-		}
+					Erase_n_First_Words( ns, 1 );		// get rid of the text, [CHAR] is removed below
+					break;
 
 
-		// theWord - collects the defining words
-		// ns - a list of words that will be consumed one after one
-		void Compile_All_Into( CompoWord< TForth > & theWord, Names & ns )
-		{
+				case EKeyword::kDotQuote:
+				case EKeyword::kCQuote:
+				case EKeyword::kSQuote:
+					{
+						// Just entered the number of tokens up to the closing "
+						Erase_n_First_Words( ns, 1 );
 
-			Compile_StructuralWords_Into( theWord, ns );
+						if( auto [ flag, str ] = CollectTextUpToTokenContaining( ns, Letter(), kQuote ); flag )
+						{
+							using EQuoteKind = QuoteSuite< TForth >::EQuoteKind;
 
+							const auto kind { keyword == EKeyword::kDotQuote ? EQuoteKind::kDotQuote : keyword == EKeyword::kSQuote ? EQuoteKind::kSQuote : EQuoteKind::kCQuote };
+							WordPtr		wp { Insert_2_NodeRepo( MakeQuoteWord( kind, std::move( str ) ) ) };
 
-			const auto kNumTokens { ns.size() };
-			if( kNumTokens == 0 )
-				return;
 
+							// Then, either execute if in the immediate mode or add to the current definition
+							if( fAllImmediate )
+							{
+								LogRun( keyword == EKeyword::kDotQuote ? kDotQuote : keyword == EKeyword::kSQuote ? kSQuote : kCQuote );
+								( * wp )();
+							}
+							else
+							{
+								theWord.AddWord( wp );
+							}
 
-			const auto & token { ns[ 0 ] };
+						}
+						else
+						{
+							throw ForthError( "no matching \" found" );
+						}
+					}
+					return;		// all tokens already consumed
 
 
-			if( IsInteger( token, ReadTheBase() ) )
-			{
-				if( fAllImmediate )
-					GetDataStack().Push( BlindValueReInterpretation< CellType >( Word_2_Integer( token ) ) );
-				else
-					theWord.AddWord( Insert_2_NodeRepo( std::make_unique< IntValWord< TForth > >( * this, Word_2_Integer( token ) ) ) );
+				case EKeyword::kAbortQuote:
+					// Just entered the number of tokens up to the closing "
 
-				Erase_n_First_Words( ns, 1 );
-				Compile_All_Into( theWord, ns );
-				return;
-			}
+					Erase_n_First_Words( ns, 1 );
 
+					if( auto [ flag, str ] = CollectTextUpToTokenContaining( ns, Letter(), kQuote ); flag )
+						if( fAllImmediate )
+							throw str;		// what to do with the immediate ABORT" ?
+						else
+							theWord.AddWord( Insert_2_NodeRepo( MakeWord< AbortQuote< TForth > >( * this, std::move( str ) ) ) );
+					else
+						throw ForthError( "no closing \" found for the opening ABORT\"" );
 
-			if( IsFloatingPt( token ) )
-			{	
-				if( fAllImmediate )
-					GetDataStack().Push( BlindValueReInterpretation< CellType >( stod( token ) ) );
-				else
-					// Const from the words' definitions are compiled into the dictionary as well 
-					theWord.AddWord( Insert_2_NodeRepo( std::make_unique< DblValWord< TForth > >( * this, stod( token) ) ) );
+					return;		// all tokens already consumed
 
-				Erase_n_First_Words( ns, 1 );
-				Compile_All_Into( theWord, ns );
-				return;
-			}
 
+				// Extract word's comment
+				case EKeyword::kLeftParen:
 
-			if( token == kDotQuote || token == kCQuote || token == kSQuote )
-			{
-				// Just entered the number of tokens up to the closing "
-				const auto loc_token { token };		// make a local copy before it is erased
-				Erase_n_First_Words( ns, 1 );
+					Erase_n_First_Words( ns, 1 );
 
-				if( auto [ flag, str ] = CollectTextUpToTokenContaining( ns, Letter(), kQuote ); flag )
-				{
-					// First, a small factory
-					WordPtr		wp {};
-					if( loc_token == kDotQuote )
-						wp = Insert_2_NodeRepo( std::make_unique< QuoteSuite< TForth > >( * this, std::move( str ), 
-																							[ this ] ( const auto & s, auto & ) { fOutStream << s; return true; } ) );
+					if( auto [ flag, str ] = CollectTextUpToTokenContaining( ns, kLeftParen, kRightParen ); flag )
+						fWordCommentStr += str;
 					else
-						if( loc_token == kSQuote )		// ( -- addr u )
-							wp = Insert_2_NodeRepo( std::make_unique< QuoteSuite< TForth > >( * this, std::move( str ), 
-																							[ this ] ( const auto & s, auto & ds ) { ds.Push( reinterpret_cast< CellType >( s.data() ) ); ds.Push( static_cast< CellType >( s.length() ) ); return true; } ) );
-						else							// ( -- addr )
-							wp = Insert_2_NodeRepo( std::make_unique< QuoteSuite< TForth > >( * this, std::move( str ), 
-																							[ this ] ( const auto & s, auto & ds ) { ds.Push( reinterpret_cast< CellType >( s.data() ) ); return true; } ) );
+						throw ForthError( "no closing \" found for the opening .\"" );
 
+					return;		// all tokens already consumed
 
-					// Then, either execute if in the immediate mode or add to the current definition
-					if( fAllImmediate )
-						( * wp )();
-					else
-						theWord.AddWord( wp );
-
-				}
-				else
-				{
-					throw ForthError( "no matching \" found" );
-				}
 
-				Compile_All_Into( theWord, ns );
-				return;
+				case EKeyword::kNone:
+					CompileWord( theWord, token );
+					break;
 			}
 
+			Erase_n_First_Words( ns, 1 );		// get rid of the processed token
+		}
 
 
-			if( token == kAbortQuote )
-			{
-				// Just entered the number of tokens up to the closing "
-
-				Erase_n_First_Words( ns, 1 );
-
-				if( auto [ flag, str ] = CollectTextUpToTokenContaining( ns, Letter(), kQuote ); flag )
-					if( fAllImmediate )
-						throw str;		// what to do with the immediate ABORT" ?
-					else
-						theWord.AddWord( Insert_2_NodeRepo( std::make_unique< AbortQuote< TForth > >( * this, std::move( str ) ) ) );
-				else
-					throw ForthError( "no closing \" found for the opening ABORT\"" );
-
-				Compile_All_Into( theWord, ns );
-				return;
-			}
-
-
-			// Extract word's comment
-			if( token == Name( 1, kLeftParen ) )
+		// Compiles a local, a word from the dictionary or a number
+		void CompileWord( CompoWord< TForth > & theWord, const Name & token )
+		{
+			// Locals take precedence over all other words
+			if( const auto slot = FindLocal( token ); slot && ! fAllImmediate )
 			{
-				// Just entered the number of tokens up to the closing "
-
-				Erase_n_First_Words( ns, 1 );
-
-				if( auto [ flag, str ] = CollectTextUpToTokenContaining( ns, kLeftParen, kRightParen ); flag )
-					fWordCommentStr += str;
-				else
-					throw ForthError( "no closing \" found for the opening .\"" );
-
-				Compile_All_Into( theWord, ns );
+				theWord.AddWord( Insert_2_NodeRepo( MakeWord< LocalFetch< TForth > >( * this, * slot ) ) );
 				return;
 			}
 
 
-
 			// Look for the words in the dictionary
 			if( const auto word_entry_ptr = GetWordEntry( token ); word_entry_ptr && ( * word_entry_ptr )->fWordIsCompiled == false )
 			{
 				// If IMMEDIATE, or in the [ ... ] context, then execute righ now
 				if( ( * word_entry_ptr )->fWordIsImmediate || fAllImmediate )
 				{
+					LogRun( token );
 					fWordDefinitionContext_4_Postpone = & theWord;	// enter the IMMEDIATE execution inside the : ; definition (used to properly handle POSTPONE)
 					( * ( (*word_entry_ptr)->fWordUP ) )();
 					fWordDefinitionContext_4_Postpone = nullptr;	// exit the IMMEDIATE mode
 				}
 				else
 				{
-					theWord.AddWord( ( * word_entry_ptr )->fWordUP.get() );
+					theWord.AddWord( GetWordPtr( ** word_entry_ptr ) );
 				}
 
-
-				Erase_n_First_Words( ns, 1 );
-				Compile_All_Into( theWord, ns );		
 				return;
 			}
-			else
+
+
+			// Only if not in the dictionary, then it can be a number
+			switch( const auto number { Word_2_Number( token, ReadTheBase() ) }; number.fKind )
 			{
-				throw ForthError( "Unknown word " + token + " used in definition" );
-			}
+				case ENumberKind::kInteger:
+					if( fAllImmediate )
+						GetDataStack().Push( BlindValueReInterpretation< CellType >( number.fIntVal ) );
+					else
+						theWord.AddWord( Insert_2_NodeRepo( MakeWord< IntValWord< TForth > >( * this, number.fIntVal ) ) );
+					break;
 
+				case ENumberKind::kFloatingPt:
+					if( fAllImmediate )
+						PushNumber( number );
+					else if( HasFloatStack() )
+						theWord.AddWord( Insert_2_NodeRepo( MakeWord< FloatValWord< TForth > >( * this, number.fFloatVal ) ) );
+					else
+						// Const from the words' definitions are compiled into the dictionary as well 
+						theWord.AddWord( Insert_2_NodeRepo( MakeWord< DblValWord< TForth > >( * this, number.fFloatVal ) ) );
+					break;
 
+				default:
+					throw ForthError( "Unknown word " + token + " used in definition" );
+			}
 		}
 
 
 
-		virtual bool EnterWordDefinition( Names && ns )
+		// Opens a new definition - ns[ 0 ] is : and ns[ 1 ] is the word name.
+		// The body of the definition is compiled by CompileWordDefinition, possibly in many calls.
+		void BeginWordDefinition( TokenCursor & ns )
 		{
-			const auto kTokens { ns.size() };
-			assert( kTokens > 2 );				// at least : [name] ;
+			assert( ns.size() > 0 && ns[ 0 ][ 0 ] == kColon );
 
-			assert( ns[ 0 ][ 0 ] == kColon );
-			assert( ns[ kTokens - 1 ][ 0 ] == kSemColon );
+			if( ns.size() <= 1 )
+				throw ForthError( "Syntax : should be followed by a word name" );
 
-			// Check if the word with that name is already registered in the dictionary (ok to overwrite?)
+			// Check if the word with that name is already registered in the current wordlist (ok to overwrite?)
+			// The same names in the other wordlists do not collide, these are just shadowed
 			const auto & word_name { ns[ 1 ] };
-			if( GetWordEntry( word_name ) )
-				if( DecisionOnWordAlreadyExists( word_name ) == false )
-					return false;	// don't overwrite
-
+			fOverwriteAllowed = ! GetCurrentWordEntry( word_name ) || DecisionOnWordAlreadyExists( word_name );
 
 			fCompiledWordName = word_name;			// store it in the case this word will be later marked as IMMEDIATE
 
 			fProcessingDefiningWord = false;		// we don't know yet
 
-			// At firt create an entry for the (possibly) new word,
-			// or replace the previous one
-
-			WordUP new_word_node { std::make_unique< CompoWord< TForth > >( * this ) };
-			CompoWord< TForth > * new_word_node_ptr { dynamic_cast< CompoWord< TForth > * >( new_word_node.get() ) };
+			fLocalNames.clear();					// locals are visible only in their own definition
 
+			// At firt create an entry for the (possibly) new word - it will be entered
+			// to the dictionary when its closing ; is reached
+			WordUP new_word_node { MakeWord< CompoWord< TForth > >( * this ) };
+			fCompileContext = dynamic_cast< CompoWord< TForth > * >( new_word_node.get() );
 
 			//                                                    is being compiled
-			WordEntry new_word_entry( std::move( new_word_node ), true, false, false, "" );
+			fNewWordEntry = WordEntry( std::move( new_word_node ), {}, true, false, false );
 
+			SetCompiling( true );
 
-			ns.erase( ns.begin() );						// remove :
-			ns.erase( ns.begin() );						// remove the word name
-			ns.erase( ns.begin() + ns.size() - 1 );		// remove ;
+			Erase_n_First_Words( ns, 2 );		// remove : and the word name
+		}
 
 
+		// Compiles ns into the open definition - returns when either the closing ; is found, 
+		// or ns is exhausted (then the definition is continued with the next call). 
+		// The tokens after ; are left in ns.
+		void CompileWordDefinition( TokenCursor & ns )
+		{
+			assert( IsCompiling() && fCompileContext != nullptr );
 
-			Compile_All_Into( * new_word_node_ptr, ns );
+			while( IsCompiling() && ns.size() > 0 )
+				CompileToken( ns );
 
+			if( IsCompiling() == false )
+				EndWordDefinition();
+		}
+
+
+		void EndWordDefinition( void )
+		{
+			fCompileContext = nullptr;
+			fLocalNames.clear();
 
-			CheckForErrors();		// will throw on errors
 
+			CheckForErrors();		// will throw on errors
 
-			new_word_entry.fWordComment = fWordCommentStr;			// copy the collected comment
-			fWordCommentStr = "";									// reset the comment string
 
-			new_word_entry.fWordIsCompiled = false;					// indicate the end of compilation
-			new_word_entry.fWordIsDefining = fProcessingDefiningWord;
-			fWordDict[ fCompiledWordName ] = std::move( new_word_entry );	// the new word is entered to the dictionary (possibly obliterating the old definition with the same name)
+			auto comment_str { std::exchange( fWordCommentStr, "" ) };	// take the collected comment and reset it
 
+			fNewWordEntry.fWordIsCompiled = false;					// indicate the end of compilation
+			fNewWordEntry.fWordIsDefining = fProcessingDefiningWord;
 
-			return true;
+			if( fOverwriteAllowed )
+			{
+				InsertEntry_2_Dict( fCompiledWordName, std::move( fNewWordEntry ), std::move( comment_str ) );	// the new word is entered to the current wordlist (possibly shadowing the old definition with the same name)
+			}
+			else
+			{
+				fNewWordEntry = WordEntry();
+			}
 		}
 
 
@@ -911,8 +835,8 @@ namespace BCForth
 		virtual bool DecisionOnWordAlreadyExists( const Name & name )
 		{
 			// We can register a callback to be launched to ask the user
-			GetOutStream() << "Warning: " << name << " overwrites the already existing word (can cause problems if that was used in other defs)\n";
-			return true;		// ok to overwrite
+			GetOutStream() << "Warning: " << name << " redefines the already existing word (the old one stays in the other defs)\n";
+			return true;		// ok to redefine
 		}
 
 	public:
@@ -924,25 +848,60 @@ namespace BCForth
 		{
 			// Passing ns as && means "it is ok to dispose ns" and indeed we consume it
 
-			const auto ns_size { ns.size() };
 
-			if( ns_size == 0 )
-				return;					// empty line is ok
+			TokenCursor tc( ns );
 
+			++ fCallDepth;
+			try
+			{
+				// A definition can span many lines, so if it is open, then its next tokens go to the compiler
+				if( IsCompiling() )
+					CompileWordDefinition( tc );
 
-			// Can be a call or a word definition
-			const auto kMinTokens4Def { 3 };
-			if( ns_size >= kMinTokens4Def && ns[ 0 ][ 0 ] == kColon && ns[ ns_size - 1 ][ 0 ] == kSemColon )
+				ExecuteWords( tc );		// execute the rest
+			}
+			catch( ... )
 			{
-				// A word definition
-				EnterWordDefinition( std::move( ns ) );		// we have to use std::move since a named rvalue (ns in our case) is an lvalue!
-			}												// since all named values are lvalues - the rule, "If it has a name, then it's an lvalue."
-			else
+				-- fCallDepth;
+				throw;
+			}
+			-- fCallDepth;
+
+			// A redefinition can leave the old word unused
+			if( fCallDepth == 0 && ! IsCompiling() && ( fReclaimRequested || GetNumOfShadowings() - fReclaimedShadowings >= kReclaimBatch ) )
 			{
-				Base::operator()( std::move( ns ) );		// call the base to execute the words (again, ns is an lvalue since it is named, so we need to call std::move)
+				fReclaimRequested = false;
+				fReclaimedShadowings = GetNumOfShadowings();
+				TDictReclaimerFor< TForthCompiler >( * this ).Reclaim();
 			}
+		}
+
+		// The garbage words go as soon as the current line ends - not at once, since a running word could be one of them
+		void RequestReclaim( void ) { fReclaimRequested = true; }
 
+	public:
+
+		// A small factory for the nodes of ." S" and C" (also used to rebuild them from an image)
+		WordUP MakeQuoteWord( const QuoteSuite< TForth >::EQuoteKind kind, Name str )
+		{
+			using EQuoteKind = QuoteSuite< TForth >::EQuoteKind;
+
+			switch( kind )
+			{
+				case EQuoteKind::kDotQuote:
+					return MakeWord< QuoteSuite< TForth > >( * this, std::move( str ), 
+																		[ this ] ( const auto & s, auto & ) { fOutStream << s; return true; }, kind );
+
+				case EQuoteKind::kSQuote:		// ( -- addr u )
+					return MakeWord< QuoteSuite< TForth > >( * this, std::move( str ), 
+																		[ this ] ( const auto & s, auto & ds ) { ds.Push( reinterpret_cast< CellType >( s.data() ) ); ds.Push( static_cast< CellType >( s.length() ) ); return true; }, kind );
+
+				case EQuoteKind::kCQuote:		// ( -- addr )
+					return MakeWord< QuoteSuite< TForth > >( * this, std::move( str ), 
+																		[ this ] ( const auto & s, auto & ds ) { ds.Push( reinterpret_cast< CellType >( s.data() ) ); return true; }, kind );
+			}
 
+			throw ForthError( "unknown kind of a text word" );
 		}
 
 	public:
@@ -969,6 +928,12 @@ namespace BCForth
 		{
 			Base::CleanUpAfterRunTimeError();					// the base will clear data and return stacks
 			fStructuralStack.clear();							// clear the structural stack
+			fLocalNames.clear();								// and the locals of a broken definition
+			fAllImmediate = false;								// leave a possibly unclosed [ ... ]
+			SetCompiling( false );								// abandon the broken definition
+			fCompileContext = nullptr;
+			fNewWordEntry = WordEntry();
+			fWordCommentStr = "";
 		}
 
 
@@ -0,0 +1,1066 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+#pragma once
+
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <typeinfo>
+#include <type_traits>
+
+
+#include "Forth.h"
+#include "SystemWords.h"
+#include "StructWords.h"
+
+
+
+
+namespace BCForth
+{
+
+
+
+
+	// The image of the dictionary - it holds the words defined in Forth, i.e. their entries and all
+	// their nodes, the data of the CREATEd words, the wordlists, the search order and BASE.
+	// So the program can start from an image rather than compile all the Forth sources again.
+	//
+	// The words written in C++ cannot be stored - an image keeps only their names, which must be the same
+	// as those entered by the modules of the program which loads it (i.e. the same build is needed).
+	// A layer is made the same way, but it holds only the words defined after the given number of definitions
+	// (e.g. those of a source file) - it can be loaded only on top of the same words (see TSourceCacheFor).
+	//
+	// The nodes are stored as records of their kinds and contents. A pointer is stored as a reference - to
+	// a node of the image (or to its branch), or to a C++ word. The addresses held in the literals and in the
+	// data cells are found and stored the same way, so all of them are relocated when the image is loaded.
+	// A number which only looks like such an address would be relocated too, but this is very unlikely.
+	// Of a reclaimed word (see TDictReclaimerFor) only its name and the number of its nodes are stored.
+	template < typename ForthComp >
+	class TForthImageFor
+	{
+		using WordPtr		= TForth::WordPtr;
+		using WordUP		= TForth::WordUP;
+		using WordEntry		= TForth::WordEntry;
+		using WordListID	= TForth::WordListID;
+		using DictMark		= TForth::DictMark;
+
+		using CW = CompoWord< TForth >;
+
+		using Byte = RawByte;
+
+		static constexpr char			kMagic[ 8 ] { 'B', 'C', 'F', 'I', 'M', 'A', 'G', 'E' };
+		static constexpr std::uint32_t	kVersion { 4 };
+
+		// A full image goes just after the C++ words, a layer goes on top of the words it was made on
+		enum class EImage : std::uint8_t { kFull, kLayer };
+
+
+		// What a stored pointer points to
+		enum class ERef : std::uint8_t { kNone, kNode, kBranch, kNative, kNodeData, kNativeData, kSystemVars };
+
+		struct Ref
+		{
+			ERef			fKind { ERef::kNone };
+			std::uint64_t	fIndex {};		// the node of the image, or the definition of the C++ word
+			std::uint64_t	fOffset {};		// the branch of the node, or the offset in its data
+		};
+
+
+	public:
+
+		// The kinds of the stored nodes
+		enum class ENode : std::uint8_t {	kCompo, kCase, kIf, kDoLoop, kILoop, kBeginLoop, kExitBeginLoop, kLocalsFrame, kLocalFetch, kLocalStore,
+											kIntVal, kDblVal, kCellVal, kCharVal, kByteArray, kQuote, kAbortQuote, kPostpone, kDoes, kFloatVal };
+
+	private:
+
+
+		// The kinds of the stored definitions
+		enum class EDef : std::uint8_t { kNodes, kVocabulary, kMarker, kReclaimed };
+
+		enum EDefFlags : std::uint8_t { kImmediate = 1, kDefining = 2, kValue = 4 };
+
+
+	private:
+
+		ForthComp &		fForth;
+
+	public:
+
+		TForthImageFor( ForthComp & f ) : fForth( f ) {}
+
+	private:
+
+		// ------------------------------------------------
+		// The image is a plain sequence of the little pieces
+
+		std::vector< Byte >		fBytes;			// the image being written
+
+		const Byte *			fData {};		// the image being read
+		size_type				fSize {};
+		size_type				fPos {};		// the reading position
+
+		template < typename T >
+		void Put( const T v )
+		{
+			static_assert( std::is_trivially_copyable_v< T > );
+			const auto p { reinterpret_cast< const Byte * >( & v ) };
+			fBytes.insert( fBytes.end(), p, p + sizeof( T ) );
+		}
+
+		void PutBytes( const void * p, const size_type n )
+		{
+			fBytes.insert( fBytes.end(), static_cast< const Byte * >( p ), static_cast< const Byte * >( p ) + n );
+		}
+
+		void PutName( const Name & n )
+		{
+			Put< std::uint64_t >( n.size() );
+			PutBytes( n.data(), n.size() );
+		}
+
+		void PutRef( const Ref & ref )
+		{
+			Put( ref.fKind );
+			Put( ref.fIndex );
+			Put( ref.fOffset );
+		}
+
+
+		const Byte * GetBytes( const size_type n )
+		{
+			if( n > fSize - fPos )
+				throw ForthError( "the image is corrupted" );
+			const auto p { fData + fPos };
+			fPos += n;
+			return p;
+		}
+
+		template < typename T >
+		T Get( void )
+		{
+			T v {};
+			std::memcpy( & v, GetBytes( sizeof( T ) ), sizeof( T ) );
+			return v;
+		}
+
+		// The number of the following items - each takes at least one byte
+		size_type GetCount( void )
+		{
+			const auto n { Get< std::uint64_t >() };
+			if( n > fSize - fPos )
+				throw ForthError( "the image is corrupted" );
+			return n;
+		}
+
+		Name GetName( void )
+		{
+			const auto n { GetCount() };
+			const auto p { reinterpret_cast< const Letter * >( GetBytes( n ) ) };
+			return Name( p, p + n );
+		}
+
+		Ref GetRef( void )
+		{
+			Ref ref;
+			ref.fKind	= Get< ERef >();
+			ref.fIndex	= Get< std::uint64_t >();
+			ref.fOffset	= Get< std::uint64_t >();
+			return ref;
+		}
+
+	public:
+
+		// ------------------------------------------------
+		// The nodes - what they are and what they refer to (also used by TDictReclaimerFor)
+
+		// Returns the kind of the node, if it can be stored
+		static std::optional< ENode > KindOf( const WordPtr wp )
+		{
+			const auto & t { typeid( * wp ) };
+
+			if( t == typeid( CW ) )							return ENode::kCompo;
+			if( t == typeid( CASE< TForth > ) )				return ENode::kCase;
+			if( t == typeid( IF< TForth > ) )				return ENode::kIf;
+			if( t == typeid( DO_LOOP< TForth > ) )			return ENode::kDoLoop;
+			if( t == typeid( I_LOOP< TForth > ) )			return ENode::kILoop;
+			if( t == typeid( BEGIN_LOOP< TForth > ) )		return ENode::kBeginLoop;
+			if( t == typeid( EXIT_BEGIN_LOOP< TForth > ) )	return ENode::kExitBeginLoop;
+			if( t == typeid( LOCALS_FRAME< TForth > ) )		return ENode::kLocalsFrame;
+			if( t == typeid( LocalFetch< TForth > ) )		return ENode::kLocalFetch;
+			if( t == typeid( LocalStore< TForth > ) )		return ENode::kLocalStore;
+			if( t == typeid( IntValWord< TForth > ) )		return ENode::kIntVal;
+			if( t == typeid( DblValWord< TForth > ) )		return ENode::kDblVal;
+			if( t == typeid( FloatValWord< TForth > ) )		return ENode::kFloatVal;
+			if( t == typeid( CellValWord< TForth > ) )		return ENode::kCellVal;
+			if( t == typeid( CharValWord< TForth > ) )		return ENode::kCharVal;
+			if( t == typeid( RawByteArray< TForth > ) )		return ENode::kByteArray;
+			if( t == typeid( QuoteSuite< TForth > ) )		return ENode::kQuote;
+			if( t == typeid( AbortQuote< TForth > ) )		return ENode::kAbortQuote;
+			if( t == typeid( Postpone< TForth > ) )			return ENode::kPostpone;
+			if( t == typeid( DOES< TForth > ) )				return ENode::kDoes;
+
+			return std::nullopt;
+		}
+
+		// The branches are the CompoWords inside the structural nodes - other nodes can also refer to them
+		template < typename Fun >
+		static void ForEachBranch( const WordPtr wp, Fun && fun )
+		{
+			if( auto * n = dynamic_cast< IF< TForth > * >( wp ) )
+				fun( 0, n->GetTrueNode() ), fun( 1, n->GetFalseNode() );
+			else if( auto * n = dynamic_cast< DO_LOOP< TForth > * >( wp ) )
+				fun( 0, n->GetBodyNodes() );
+			else if( auto * n = dynamic_cast< BEGIN_LOOP< TForth > * >( wp ) )
+				fun( 0, n->Get_Begin_Nodes() ), fun( 1, n->Get_While_Nodes() );
+			else if( auto * n = dynamic_cast< LOCALS_FRAME< TForth > * >( wp ) )
+				fun( 0, n->GetBodyNodes() );
+			else if( auto * n = dynamic_cast< DOES< TForth > * >( wp ) )
+				fun( 0, n->GetCreationNode() ), fun( 1, n->GetBehaviorNode() );
+		}
+
+		static CW * GetBranch( const WordPtr wp, const size_type slot )
+		{
+			CW * branch {};
+			ForEachBranch( wp, [ & ] ( const size_type s, CW & b ) { if( s == slot ) branch = & b; } );
+			return branch;
+		}
+
+		// The data of a node, to which an address can point
+		static std::pair< Byte *, size_type > DataOf( const WordPtr wp )
+		{
+			if( auto * arr = dynamic_cast< RawByteArray< TForth > * >( wp ) )
+				return { arr->GetData().data(), arr->GetData().size() };
+			if( auto * quote = dynamic_cast< QuoteSuite< TForth > * >( wp ) )
+				return { reinterpret_cast< Byte * >( const_cast< Letter * >( quote->GetText().data() ) ), quote->GetText().size() };
+			return { nullptr, 0 };
+		}
+
+	private:
+
+
+		// All words, in the order of their definitions
+		std::vector< std::pair< const Name *, WordEntry * > > CollectDefs( void )
+		{
+			std::vector< std::pair< const Name *, WordEntry * > > defs( fForth.GetDefLog().size() );
+
+			for( WordListID wid {}; wid < fForth.GetNumOfWordLists(); ++ wid )
+				for( auto && [ name, entry ] : fForth.GetWordList( wid ) )
+					defs[ entry.fDefSeq ] = { & name, & entry };
+
+			return defs;
+		}
+
+	private:
+
+		// ------------------------------------------------
+		// Saving
+
+		std::unordered_map< CellType, Ref >		fNodeRefs;		// the address of a node -> its reference
+
+		struct DataRegion
+		{
+			size_type	fSize {};
+			Ref			fBase;
+		};
+
+		std::map< CellType, DataRegion >		fDataRegions;	// the beginning of data -> its reference
+
+
+		void AddNode( const WordPtr wp, const Ref & ref )
+		{
+			fNodeRefs.emplace( reinterpret_cast< CellType >( wp ), ref );
+
+			if( const auto [ data, size ] = DataOf( wp ); size > 0 )
+				fDataRegions[ reinterpret_cast< CellType >( data ) ] = { size, { ref.fKind == ERef::kNative ? ERef::kNativeData : ERef::kNodeData, ref.fIndex } };
+		}
+
+		// Returns the reference if v is an address of a node or of the data, which go to the image
+		std::optional< Ref > FindAddress( const CellType v ) const
+		{
+			if( const auto pos { fNodeRefs.find( v ) }; pos != fNodeRefs.end() )
+				return pos->second;
+
+			if( auto pos { fDataRegions.upper_bound( v ) }; pos != fDataRegions.begin() )
+				if( -- pos; v - pos->first <= pos->second.fSize )		// the end of the data is also fine
+				{
+					auto ref { pos->second.fBase };
+					ref.fOffset = v - pos->first;
+					return ref;
+				}
+
+			return std::nullopt;
+		}
+
+		Ref NodeRef( const WordPtr wp, const Name & word_name ) const
+		{
+			if( const auto pos { fNodeRefs.find( reinterpret_cast< CellType >( wp ) ) }; pos != fNodeRefs.end() )
+				return pos->second;
+
+			throw ForthError( "the word " + word_name + " uses a word which cannot be stored in an image" );
+		}
+
+		void PutWords( const typename CW::WordsVec & words, const Name & word_name )
+		{
+			Put< std::uint64_t >( words.size() );
+			for( const auto wp : words )
+				PutRef( NodeRef( wp, word_name ) );
+		}
+
+		// The data goes with the addresses found in its cells
+		void PutData( const std::span< const Byte > data )
+		{
+			Put< std::uint64_t >( data.size() );
+			PutBytes( data.data(), data.size() );
+
+			std::vector< std::pair< size_type, Ref > > fixups;
+			for( size_type offset {}; offset + sizeof( CellType ) <= data.size(); offset += sizeof( CellType ) )
+			{
+				CellType v {};
+				std::memcpy( & v, data.data() + offset, sizeof( v ) );
+				if( v != 0 )
+					if( const auto ref { FindAddress( v ) } )
+						fixups.emplace_back( offset, * ref );
+			}
+
+			Put< std::uint64_t >( fixups.size() );
+			for( const auto & [ offset, ref ] : fixups )
+				Put< std::uint64_t >( offset ), PutRef( ref );
+		}
+
+		void PutNode( const WordPtr wp, const Name & word_name )
+		{
+			const auto kind { KindOf( wp ) };
+			if( ! kind )
+				throw ForthError( "the word " + word_name + " cannot be stored in an image" );
+
+			Put( * kind );
+
+			switch( * kind )
+			{
+				case ENode::kCompo:
+				case ENode::kCase:
+					PutWords( static_cast< CW * >( wp )->GetWordsVec(), word_name );
+					break;
+
+				case ENode::kIf:
+				case ENode::kDoLoop:
+				case ENode::kLocalsFrame:
+				case ENode::kDoes:
+					if( * kind == ENode::kLocalsFrame )
+					{
+						const auto * frame { static_cast< LOCALS_FRAME< TForth > * >( wp ) };
+						Put< std::uint64_t >( frame->GetNumOfArgs() );
+						Put< std::uint64_t >( frame->GetNumOfLocals() );
+					}
+					ForEachBranch( wp, [ & ] ( const size_type, CW & b ) { PutWords( b.GetWordsVec(), word_name ); } );
+					break;
+
+				case ENode::kBeginLoop:
+					Put( static_cast< std::uint8_t >( static_cast< BEGIN_LOOP< TForth > * >( wp )->GetLoopType() ) );
+					ForEachBranch( wp, [ & ] ( const size_type, CW & b ) { PutWords( b.GetWordsVec(), word_name ); } );
+					break;
+
+				case ENode::kILoop:
+					PutRef( NodeRef( const_cast< DO_LOOP< TForth > * >( & static_cast< I_LOOP< TForth > * >( wp )->GetLoopNode() ), word_name ) );
+					break;
+
+				case ENode::kExitBeginLoop:
+					PutRef( NodeRef( & static_cast< EXIT_BEGIN_LOOP< TForth > * >( wp )->GetBeginNode(), word_name ) );
+					break;
+
+				case ENode::kPostpone:
+					PutRef( NodeRef( static_cast< Postpone< TForth > * >( wp )->GetWordPtr(), word_name ) );
+					break;
+
+				case ENode::kLocalFetch:
+					Put< std::uint64_t >( static_cast< LocalFetch< TForth > * >( wp )->GetSlot() );
+					break;
+
+				case ENode::kLocalStore:
+					Put< std::uint64_t >( static_cast< LocalStore< TForth > * >( wp )->GetSlot() );
+					break;
+
+				case ENode::kIntVal:
+					Put( static_cast< IntValWord< TForth > * >( wp )->GetVal() );
+					break;
+
+				case ENode::kDblVal:
+					Put( static_cast< DblValWord< TForth > * >( wp )->GetVal() );
+					break;
+
+				case ENode::kFloatVal:
+					Put( static_cast< FloatValWord< TForth > * >( wp )->GetVal() );
+					break;
+
+				case ENode::kCharVal:
+					Put( static_cast< CharValWord< TForth > * >( wp )->GetVal() );
+					break;
+
+				case ENode::kCellVal:
+					{
+						// The literals of ['] and TO are the addresses
+						const auto v { static_cast< CellValWord< TForth > * >( wp )->GetVal() };
+						Put( v );
+						PutRef( v != 0 ? FindAddress( v ).value_or( Ref() ) : Ref() );
+					}
+					break;
+
+				case ENode::kByteArray:
+					PutData( static_cast< RawByteArray< TForth > * >( wp )->GetData() );
+					break;
+
+				case ENode::kQuote:
+					Put( static_cast< QuoteSuite< TForth > * >( wp )->GetKind() );
+					PutName( static_cast< QuoteSuite< TForth > * >( wp )->GetText() );
+					break;
+
+				case ENode::kAbortQuote:
+					PutName( static_cast< AbortQuote< TForth > * >( wp )->GetText() );
+					break;
+			}
+		}
+
+		void PutMark( const DictMark & mark, const size_type repo_base )
+		{
+			Put< std::uint64_t >( mark.fNumDefs );
+			Put< std::uint64_t >( mark.fNumNodes - std::min( mark.fNumNodes, repo_base ) );
+			Put< std::uint64_t >( mark.fNumWordLists );
+			Put< std::uint64_t >( mark.fSearchOrder.size() );
+			for( const auto wid : mark.fSearchOrder )
+				Put< std::uint64_t >( wid );
+			Put< std::uint64_t >( mark.fCurrent );
+		}
+
+		static EDef DefKindOf( const WordPtr wp )
+		{
+			if( dynamic_cast< VocabularyWord< TForth > * >( wp ) )
+				return EDef::kVocabulary;
+			if( dynamic_cast< Marker< TForth > * >( wp ) )
+				return EDef::kMarker;
+			return EDef::kNodes;
+		}
+
+	public:
+
+		// Writes the image of the dictionary to the file
+		void Save( const Name & path )
+		{
+			const auto bytes { Make() };
+
+			std::ofstream file( path, std::ios::binary );
+			if( ! file || ! file.write( reinterpret_cast< const char * >( bytes.data() ), bytes.size() ) )
+				throw ForthError( "cannot write the image to " + path );
+		}
+
+		// Returns the image of the dictionary
+		std::vector< Byte > Make( void ) { return MakeImage( EImage::kFull, fForth.GetNumOfNativeDefs() ); }
+
+		// Returns the image of the words defined after the first base_defs definitions
+		std::vector< Byte > MakeLayer( const size_type base_defs ) { return MakeImage( EImage::kLayer, base_defs ); }
+
+	private:
+
+		// The definitions below kNumNatives are not stored, only referred to - these are the C++ words
+		// of a full image, or all the words the layer was made on
+		std::vector< Byte > MakeImage( const EImage image_kind, const size_type kNumNatives )
+		{
+			fBytes.clear();
+
+			const auto defs { CollectDefs() };
+			const auto & def_log { fForth.GetDefLog() };
+			const auto & repo { fForth.GetNodeRepo() };
+
+			if( kNumNatives > def_log.size() )
+				throw ForthError( "the words of the layer have been forgotten" );
+
+			// The nodes of each definition are in the repo after those of the previous one - the C++ words go first
+			const auto kRepoBase { kNumNatives < def_log.size() ? def_log[ kNumNatives ].fNodeMark : repo.size() };
+			auto group_end = [ & ] ( const size_type seq ) { return seq + 1 < def_log.size() ? def_log[ seq + 1 ].fNodeMark : repo.size(); };
+
+
+			// At first, all nodes are given their references, since they can point forward
+			for( size_type seq {}; seq < kNumNatives; ++ seq )
+			{
+				if( defs[ seq ].second->fWordIsReclaimed )
+					continue;
+
+				AddNode( defs[ seq ].second->fWordUP.get(), { ERef::kNative, seq } );
+
+				// The words compiled after the module was made call its word directly - on loading they get the LazyWord
+				if( const auto wp { fForth.GetWordPtr( * defs[ seq ].second ) }; wp != defs[ seq ].second->fWordUP.get() )
+					fNodeRefs.emplace( reinterpret_cast< CellType >( wp ), Ref { ERef::kNative, seq } );
+			}
+
+			std::vector< WordPtr > nodes;
+			auto add_node = [ & ] ( const WordPtr wp )
+			{
+				AddNode( wp, { ERef::kNode, nodes.size() } );
+				ForEachBranch( wp, [ & ] ( const size_type slot, CW & b ) { AddNode( & b, { ERef::kBranch, nodes.size(), slot } ); } );
+				nodes.push_back( wp );
+			};
+
+			for( auto seq { kNumNatives }; seq < def_log.size(); ++ seq )
+			{
+				if( defs[ seq ].second->fWordIsReclaimed )
+					continue;
+
+				for( auto i { def_log[ seq ].fNodeMark }; i < group_end( seq ); ++ i )
+					add_node( repo[ i ].get() );
+
+				if( const auto root { defs[ seq ].second->fWordUP.get() }; DefKindOf( root ) == EDef::kNodes )
+					add_node( root );
+			}
+
+			const auto & sys_vars { fForth.GetSystemVars() };
+			fDataRegions[ reinterpret_cast< CellType >( & sys_vars ) ] = { sizeof( sys_vars ), { ERef::kSystemVars } };
+
+
+			// The header
+			PutBytes( kMagic, sizeof( kMagic ) );
+			Put( kVersion );
+			Put< std::uint8_t >( sizeof( CellType ) );
+			Put( image_kind );
+
+			// The C++ words - only to check them
+			Put< std::uint64_t >( kNumNatives );
+			for( size_type seq {}; seq < kNumNatives; ++ seq )
+				Put< std::uint64_t >( def_log[ seq ].fWordList ), PutName( * defs[ seq ].first );
+
+			Put< std::uint64_t >( fForth.GetNumOfWordLists() );
+			for( WordListID wid {}; wid < fForth.GetNumOfWordLists(); ++ wid )
+				PutName( fForth.GetWordListName( wid ) ), Put< std::uint64_t >( fForth.GetWordListDefSeq( wid ) );
+
+			// The words defined in Forth, each with its nodes
+			Put< std::uint64_t >( def_log.size() - kNumNatives );
+			Put< std::uint64_t >( fForth.GetDictFence() );
+			for( auto seq { kNumNatives }; seq < def_log.size(); ++ seq )
+			{
+				const auto & [ name, entry ] { defs[ seq ] };
+
+				Put< std::uint64_t >( def_log[ seq ].fWordList );
+				PutName( * name );
+				PutName( def_log[ seq ].fWordComment );
+				Put< std::uint8_t >( ( entry->fWordIsImmediate ? kImmediate : 0 ) | ( entry->fWordIsDefining ? kDefining : 0 ) | ( entry->fWordIsValue ? kValue : 0 ) );
+
+				// Only the number of the nodes of a reclaimed word, which are all gone
+				if( entry->fWordIsReclaimed )
+				{
+					Put< std::uint64_t >( 0 );
+					Put( EDef::kReclaimed );
+					Put< std::uint64_t >( group_end( seq ) - def_log[ seq ].fNodeMark );
+					continue;
+				}
+
+				Put< std::uint64_t >( group_end( seq ) - def_log[ seq ].fNodeMark );
+				for( auto i { def_log[ seq ].fNodeMark }; i < group_end( seq ); ++ i )
+					PutNode( repo[ i ].get(), * name );
+
+				const auto root { entry->fWordUP.get() };
+				const auto kind { DefKindOf( root ) };
+				Put( kind );
+
+				if( kind == EDef::kNodes )
+					PutNode( root, * name );
+				else if( kind == EDef::kVocabulary )
+					Put< std::uint64_t >( static_cast< VocabularyWord< TForth > * >( root )->GetWordList() );
+				else
+					PutMark( static_cast< Marker< TForth > * >( root )->GetMark(), kRepoBase );
+			}
+
+			// The data of the C++ words, such as PAD (a layer leaves the data of the words below it as they are)
+			std::vector< size_type > native_arrays;
+			for( size_type seq {}; seq < kNumNatives && image_kind == EImage::kFull; ++ seq )
+				if( dynamic_cast< RawByteArray< TForth > * >( defs[ seq ].second->fWordUP.get() ) )
+					native_arrays.push_back( seq );
+
+			Put< std::uint64_t >( native_arrays.size() );
+			for( const auto seq : native_arrays )
+				Put< std::uint64_t >( seq ), PutData( static_cast< RawByteArray< TForth > * >( defs[ seq ].second->fWordUP.get() )->GetData() );
+
+			// The state
+			const auto & order { fForth.GetSearchOrder() };
+			Put< std::uint64_t >( order.size() );
+			for( size_type i {}; i < order.size(); ++ i )
+				Put< std::uint64_t >( order.data()[ i ] );
+			Put< std::uint64_t >( fForth.GetCurrent() );
+			Put< std::uint64_t >( sys_vars.fBase );
+
+			return std::move( fBytes );
+		}
+
+	private:
+
+		// ------------------------------------------------
+		// Loading
+
+		std::vector< WordPtr >		fNatives;		// the definition -> the C++ word
+		std::vector< WordPtr >		fNodes;			// the nodes of the image, in their order
+
+		// The links are made when all nodes they can point to are there
+		std::vector< std::pair< CW *, std::vector< Ref > > >				fPendingWords;
+		std::vector< std::pair< CellValWord< TForth > *, Ref > >			fPendingValues;
+		std::vector< std::tuple< RawByteArray< TForth > *, size_type, Ref > >	fPendingCells;
+
+
+		WordPtr ResolveNode( const Ref & ref ) const
+		{
+			WordPtr wp {};
+
+			if( ref.fKind == ERef::kNode && ref.fIndex < fNodes.size() )
+				wp = fNodes[ ref.fIndex ];
+			else if( ref.fKind == ERef::kBranch && ref.fIndex < fNodes.size() )
+				wp = GetBranch( fNodes[ ref.fIndex ], ref.fOffset );
+			else if( ref.fKind == ERef::kNative && ref.fIndex < fNatives.size() )
+				wp = fNatives[ ref.fIndex ];
+
+			if( wp == nullptr )
+				throw ForthError( "the image is corrupted" );
+
+			return wp;
+		}
+
+		CellType ResolveAddress( const Ref & ref )
+		{
+			std::pair< Byte *, size_type > data {};
+
+			switch( ref.fKind )
+			{
+				case ERef::kNode:
+				case ERef::kBranch:
+				case ERef::kNative:
+					return reinterpret_cast< CellType >( ResolveNode( ref ) );
+
+				case ERef::kNodeData:
+					data = DataOf( ResolveNode( { ERef::kNode, ref.fIndex } ) );
+					break;
+
+				case ERef::kNativeData:
+					data = DataOf( ResolveNode( { ERef::kNative, ref.fIndex } ) );
+					break;
+
+				case ERef::kSystemVars:
+					data = { reinterpret_cast< Byte * >( & fForth.GetSystemVars() ), sizeof( typename TForth::SystemVars ) };
+					break;
+
+				default:
+					break;
+			}
+
+			if( data.first == nullptr || ref.fOffset > data.second )
+				throw ForthError( "the image is corrupted" );
+
+			return reinterpret_cast< CellType >( data.first + ref.fOffset );
+		}
+
+		template < typename Node >
+		Node & GetNodeRefOf( void )
+		{
+			if( auto * n = dynamic_cast< Node * >( ResolveNode( GetRef() ) ) )
+				return * n;
+			throw ForthError( "the image is corrupted" );
+		}
+
+		void GetWords( CW & cw )
+		{
+			std::vector< Ref > refs( GetCount() );
+			for( auto & ref : refs )
+				ref = GetRef();
+			fPendingWords.emplace_back( & cw, std::move( refs ) );
+		}
+
+		// A new data field gets its bytes at HERE, that of a C++ word (PAD) has them already
+		void GetData( RawByteArray< TForth > & arr, const bool is_new = true )
+		{
+			const auto n { GetCount() };
+			const auto p { GetBytes( n ) };
+			if( is_new )
+				fForth.AllotData( n );
+			else if( arr.GetData().size() != n )
+				throw ForthError( "the image is corrupted" );
+			std::copy( p, p + n, arr.GetData().data() );
+
+			for( auto num_fixups { GetCount() }; num_fixups -- > 0; )
+			{
+				const auto offset { Get< std::uint64_t >() };
+				if( offset + sizeof( CellType ) > n )
+					throw ForthError( "the image is corrupted" );
+				fPendingCells.emplace_back( & arr, offset, GetRef() );
+			}
+		}
+
+		// Makes the node of the record and puts it to fNodes
+		WordUP GetNode( void )
+		{
+			WordUP wp;
+
+			switch( const auto kind { Get< ENode >() } )
+			{
+				case ENode::kCompo:
+					wp = MakeWord< CW >( fForth );
+					GetWords( static_cast< CW & >( * wp ) );
+					break;
+
+				case ENode::kCase:
+					wp = MakeWord< CASE< TForth > >( fForth );
+					GetWords( static_cast< CW & >( * wp ) );
+					break;
+
+				case ENode::kIf:
+					wp = MakeWord< IF< TForth > >( fForth );
+					break;
+
+				case ENode::kDoLoop:
+					wp = MakeWord< DO_LOOP< TForth > >( fForth );
+					break;
+
+				case ENode::kDoes:
+					wp = MakeWord< DOES< TForth > >( fForth );
+					break;
+
+				case ENode::kLocalsFrame:
+					{
+						const auto num_args { Get< std::uint64_t >() };
+						const auto num_locals { Get< std::uint64_t >() };
+						if( num_args > num_locals )
+							throw ForthError( "the image is corrupted" );
+						wp = MakeWord< LOCALS_FRAME< TForth > >( fForth, num_args, num_locals );
+					}
+					break;
+
+				case ENode::kBeginLoop:
+					{
+						using EBeginLoopType = typename BEGIN_LOOP< TForth >::EBeginLoopType;
+						const auto loop_type { Get< std::uint8_t >() };
+						if( loop_type > static_cast< std::uint8_t >( EBeginLoopType::kExit ) )
+							throw ForthError( "the image is corrupted" );
+						auto begin_node { MakeWord< BEGIN_LOOP< TForth > >( fForth ) };
+						begin_node->SetLoopType( static_cast< EBeginLoopType >( loop_type ) );
+						wp = std::move( begin_node );
+					}
+					break;
+
+				case ENode::kILoop:
+					wp = MakeWord< I_LOOP< TForth > >( fForth, GetNodeRefOf< DO_LOOP< TForth > >() );
+					break;
+
+				case ENode::kExitBeginLoop:
+					wp = MakeWord< EXIT_BEGIN_LOOP< TForth > >( fForth, GetNodeRefOf< BEGIN_LOOP< TForth > >() );
+					break;
+
+				case ENode::kPostpone:
+					wp = MakeWord< Postpone< TForth > >( fForth, ResolveNode( GetRef() ) );
+					break;
+
+				case ENode::kLocalFetch:
+					wp = MakeWord< LocalFetch< TForth > >( fForth, Get< std::uint64_t >() );
+					break;
+
+				case ENode::kLocalStore:
+					wp = MakeWord< LocalStore< TForth > >( fForth, Get< std::uint64_t >() );
+					break;
+
+				case ENode::kIntVal:
+					wp = MakeWord< IntValWord< TForth > >( fForth, Get< SignedIntType >() );
+					break;
+
+				// A float literal goes to the stack it was compiled for, so it must be the same
+				case ENode::kDblVal:
+					if( fForth.HasFloatStack() )
+						throw ForthError( "the words were compiled with no floating-point stack" );
+					wp = MakeWord< DblValWord< TForth > >( fForth, Get< FloatType >() );
+					break;
+
+				case ENode::kFloatVal:
+					if( ! fForth.HasFloatStack() )
+						throw ForthError( "the words were compiled for the floating-point stack" );
+					wp = MakeWord< FloatValWord< TForth > >( fForth, Get< FloatType >() );
+					break;
+
+				case ENode::kCharVal:
+					wp = MakeWord< CharValWord< TForth > >( fForth, Get< Char >() );
+					break;
+
+				case ENode::kCellVal:
+					{
+						auto val_node { MakeWord< CellValWord< TForth > >( fForth, Get< CellType >() ) };
+						if( const auto ref { GetRef() }; ref.fKind != ERef::kNone )
+							fPendingValues.emplace_back( val_node.get(), ref );
+						wp = std::move( val_node );
+					}
+					break;
+
+				case ENode::kByteArray:
+					{
+						auto arr { MakeWord< RawByteArray< TForth > >( fForth ) };
+						GetData( * arr );
+						wp = std::move( arr );
+					}
+					break;
+
+				case ENode::kQuote:
+					{
+						using EQuoteKind = typename QuoteSuite< TForth >::EQuoteKind;
+						const auto quote_kind { Get< EQuoteKind >() };
+						if( quote_kind > EQuoteKind::kCQuote )
+							throw ForthError( "the image is corrupted" );
+						wp = fForth.MakeQuoteWord( quote_kind, GetName() );
+					}
+					break;
+
+				case ENode::kAbortQuote:
+					wp = MakeWord< AbortQuote< TForth > >( fForth, GetName() );
+					break;
+
+				default:
+					throw ForthError( "the image is corrupted" );
+			}
+
+			// The branches are read after the node, since they come with it
+			ForEachBranch( wp.get(), [ this ] ( const size_type, CW & b ) { GetWords( b ); } );
+
+			fNodes.push_back( wp.get() );
+			return wp;
+		}
+
+		// Fills in the CompoWords read so far - the vectors go to the node arena just after the nodes of their definition
+		void LinkNodes( void )
+		{
+			for( auto & [ cw, refs ] : fPendingWords )
+				for( const auto & ref : refs )
+					cw->AddWord( ResolveNode( ref ) );
+
+			fPendingWords.clear();
+		}
+
+		DictMark GetMark( const size_type repo_base )
+		{
+			DictMark mark;
+			mark.fNumDefs		= Get< std::uint64_t >();
+			mark.fNumNodes		= Get< std::uint64_t >() + repo_base;
+			mark.fArenaMark		= fForth.GetNodeArena().GetMark();		// the marker goes just after its nodes
+			mark.fDataMark		= fForth.GetDataSpace().Used();			// and after the data below it
+			mark.fNumWordLists	= Get< std::uint64_t >();
+			mark.fSearchOrder.resize( GetCount() );
+			for( auto & wid : mark.fSearchOrder )
+				wid = Get< std::uint64_t >();
+			mark.fCurrent		= Get< std::uint64_t >();
+			return mark;
+		}
+
+	public:
+
+		// Reads the image from the file and enters its words to the dictionary
+		void Load( const Name & path )
+		{
+			// The whole file is read at once, then the words are made from it
+			std::vector< Byte > bytes;
+
+			if( std::ifstream file( path, std::ios::binary | std::ios::ate ); file )
+			{
+				bytes.resize( static_cast< size_type >( file.tellg() ) );
+				file.seekg( 0 );
+				if( ! file.read( reinterpret_cast< char * >( bytes.data() ), bytes.size() ) )
+					throw ForthError( "cannot read the image " + path );
+			}
+			else
+			{
+				throw ForthError( "cannot open the image " + path );
+			}
+
+			Load( bytes.data(), bytes.size(), path );
+		}
+
+		// Enters the words of the image to the dictionary. It should be called just after
+		// the modules of the C++ words, instead of compiling the words defined in Forth.
+		void Load( const Byte * data, const size_type size, const Name & path ) { LoadImage( EImage::kFull, data, size, path ); }
+
+		// Enters the words of the layer - the dictionary must be the same as the one it was made on
+		void LoadLayer( const Byte * data, const size_type size, const Name & path ) { LoadImage( EImage::kLayer, data, size, path ); }
+
+	private:
+
+		void LoadImage( const EImage image_kind, const Byte * data, const size_type size, const Name & path )
+		{
+			fData = data;
+			fSize = size;
+			fPos = 0;
+
+			if( fSize < sizeof( kMagic ) || std::memcmp( GetBytes( sizeof( kMagic ) ), kMagic, sizeof( kMagic ) ) != 0 )
+				throw ForthError( path + " is not an image" );
+
+			if( Get< std::uint32_t >() != kVersion || Get< std::uint8_t >() != sizeof( CellType ) )
+				throw ForthError( "the image " + path + " was made by another version of the program" );
+
+			if( Get< EImage >() != image_kind )
+				throw ForthError( image_kind == EImage::kFull ? path + " is a layer, not a full image" : path + " is not a layer" );
+
+
+			const auto defs { CollectDefs() };
+			const auto & def_log { fForth.GetDefLog() };
+			const auto kNumNatives { image_kind == EImage::kFull ? fForth.GetNumOfNativeDefs() : def_log.size() };
+
+			if( def_log.size() != kNumNatives )
+				throw ForthError( "an image can be loaded only just after the C++ words" );
+
+			// The C++ words must be the same
+			const Name kMismatch { "the image " + path + " does not match the words of this program" };
+
+			if( Get< std::uint64_t >() != kNumNatives )
+				throw ForthError( kMismatch );
+
+			for( size_type seq {}; seq < kNumNatives; ++ seq )
+			{
+				const auto wid { Get< std::uint64_t >() };
+				if( wid != def_log[ seq ].fWordList || GetName() != * defs[ seq ].first )
+					throw ForthError( kMismatch );
+				fNatives.push_back( defs[ seq ].second->fWordUP.get() );
+			}
+
+			// The wordlists of the modules are already there, the others are made at their places among the definitions
+			std::vector< std::pair< Name, size_type > > word_lists( GetCount() );
+			for( auto & [ name, def_seq ] : word_lists )
+				name = GetName(), def_seq = Get< std::uint64_t >();
+
+			if( word_lists.size() < fForth.GetNumOfWordLists() )
+				throw ForthError( kMismatch );
+
+			for( WordListID wid {}; wid < fForth.GetNumOfWordLists(); ++ wid )
+				if( word_lists[ wid ].first != fForth.GetWordListName( wid ) )
+					throw ForthError( kMismatch );
+
+			auto make_word_lists = [ & ] ()
+			{
+				for( auto wid { fForth.GetNumOfWordLists() }; wid < word_lists.size() && word_lists[ wid ].second <= def_log.size(); ++ wid )
+					fForth.NewWordList( word_lists[ wid ].first );
+			};
+
+
+			// The definitions
+			const auto kNumDefs { GetCount() };
+			const auto kFence { Get< std::uint64_t >() };
+			const auto kRepoBase { fForth.GetNodeRepo().size() };
+
+			// The fence of a layer is below it
+			auto set_fence = [ &, fence_set = image_kind == EImage::kLayer ] () mutable
+			{
+				if( ! fence_set && def_log.size() >= kFence )
+					fForth.SetDictFence(), fence_set = true;
+			};
+
+			for( std::uint64_t d {}; d < kNumDefs; ++ d )
+			{
+				set_fence();
+				make_word_lists();
+
+				const auto wid { Get< std::uint64_t >() };
+				const auto name { GetName() };
+				const auto comment { GetName() };
+				const auto flags { Get< std::uint8_t >() };
+
+				for( auto num_nodes { GetCount() }; num_nodes -- > 0; )
+					fForth.Insert_2_NodeRepo( GetNode() );
+
+				LinkNodes();
+
+				WordUP root;
+				switch( Get< EDef >() )
+				{
+					case EDef::kNodes:
+						root = GetNode();
+						LinkNodes();
+						break;
+
+					case EDef::kVocabulary:
+						{
+							const auto voc_wid { Get< std::uint64_t >() };
+							fForth.GetWordList( voc_wid );		// throws if there is no such wordlist
+							root = MakeWord< VocabularyWord< TForth > >( fForth, voc_wid );
+						}
+						break;
+
+					case EDef::kMarker:
+						root = MakeWord< Marker< TForth > >( fForth, GetMark( kRepoBase ) );
+						break;
+
+					case EDef::kReclaimed:
+						if( const auto num_nodes { Get< std::uint64_t >() }; num_nodes <= std::numeric_limits< std::uint32_t >::max() )
+						{
+							fForth.SetCurrent( wid );
+							fForth.InsertReclaimedWord_2_Dict( name, num_nodes, comment );
+							continue;
+						}
+						throw ForthError( "the image is corrupted" );
+
+					default:
+						throw ForthError( "the image is corrupted" );
+				}
+
+				fForth.SetCurrent( wid );
+				fForth.InsertWord_2_Dict( name, std::move( root ), comment, false, ( flags & kImmediate ) != 0, ( flags & kDefining ) != 0, ( flags & kValue ) != 0 );
+			}
+
+			set_fence();
+			make_word_lists();
+
+			if( fForth.GetNumOfWordLists() != word_lists.size() )
+				throw ForthError( "the image is corrupted" );
+
+
+			// The data of the C++ words
+			for( auto num_arrays { GetCount() }; num_arrays -- > 0; )
+			{
+				const auto seq { Get< std::uint64_t >() };
+				auto * arr { seq < fNatives.size() ? dynamic_cast< RawByteArray< TForth > * >( fNatives[ seq ] ) : nullptr };
+				if( arr == nullptr )
+					throw ForthError( kMismatch );
+				GetData( * arr, false );
+			}
+
+
+			// The state
+			const auto kOrderSize { Get< std::uint64_t >() };
+			if( kOrderSize == 0 || kOrderSize > TForth::kMaxSearchOrder )
+				throw ForthError( "the image is corrupted" );
+
+			fForth.Only();
+			for( std::uint64_t i {}; i < kOrderSize; ++ i )
+			{
+				if( i > 0 )
+					fForth.Also();
+				fForth.SetSearchOrderTop( Get< std::uint64_t >() );
+			}
+
+			fForth.SetCurrent( Get< std::uint64_t >() );
+			fForth.GetSystemVars().fBase = Get< std::uint64_t >();
+
+
+			// At last, all the addresses can be set
+			for( const auto & [ val_node, ref ] : fPendingValues )
+				val_node->SetVal( ResolveAddress( ref ) );
+
+			for( const auto & [ arr, offset, ref ] : fPendingCells )
+			{
+				const auto v { ResolveAddress( ref ) };
+				std::memcpy( arr->GetData().data() + offset, & v, sizeof( v ) );
+			}
+		}
+
+	};
+
+
+
+
+}	// The end of the BCForth namespace
@@ -16,6 +16,8 @@
 #include "Forth.h"
 #include "SystemWords.h"
 #include "StructWords.h"
+#include <charconv>
+#include <limits>
 
 
 
@@ -33,7 +35,9 @@ namespace BCForth
 
 		using Base = TForth;
 
-		using Base::fWordDict;
+	public:
+
+		using TForth::TForth;		// the stack capacities
 
 
 
@@ -49,11 +53,17 @@ namespace BCForth
 
 	protected:
 
+		Names *		fRunLog {};		// if set, then the names of the words run outside the definitions go there
 
-		const std::regex kIntVal	{ R"(([+-]?\d+))" };
-		const std::regex kHexIntVal { R"((0[x|X][\da-fA-F]+))" };		// use the C++ syntax
+		void LogRun( const Name & name ) { if( fRunLog != nullptr ) fRunLog->push_back( name ); }
 
-		const std::regex kFloatPtVal { R"([+-]?(\d+[.]\d*([eE][+-]?\d+)?|[.]\d+([eE][+-]?\d+)?))" };		// always require a dot inside
+	public:
+
+		// Returns the previous log (e.g. of the file which includes this one)
+		Names * SetRunLog( Names * log ) { return std::exchange( fRunLog, log ); }
+
+
+	protected:
 
 
 		// A language cathegory in a word definition can be as follows:
@@ -70,58 +80,144 @@ namespace BCForth
 		// - IO operations: . (dot), .", "
 		// - CONSTANT and VARIABLE
 
-	public:
 
-		EIntCompBase ReadTheBase( void ) override
+	protected:
+
+		enum class ENumberKind { kNotANumber, kInteger, kFloatingPt };
+
+		struct TNumber
+		{
+			ENumberKind		fKind { ENumberKind::kNotANumber };
+			SignedIntType	fIntVal {};
+			FloatType		fFloatVal {};
+		};
+
+
+		// A single-pass classification and conversion of a numeric literal. 
+		// An integer is written in the current base (2-36), with an optional sign; 
+		// in the hex base the C++ prefix 0x is also accepted, as in 0x1F. 
+		// A floating-point value always requires a dot inside, as in 1. or -.5 or 1.5e-3
+		// Should be called only for tokens which are not in the dictionary.
+		TNumber Word_2_Number( const Name & word, const int base )
 		{
-			if( auto base_word_entry = GetWordEntry( "BASE" ) )														// if exists, BASE is a Forth's variable
-				if( auto * we = dynamic_cast< CompoWord< TForth > * >( (*base_word_entry)->fWordUP.get() ) )		// each Forth's word contains a CompoWord
-					if( auto & compo_vec = we->GetWordsVec(); compo_vec.size() > 0 )								// The CompoWord should contain sub-words
-						if( auto * byte_arr = dynamic_cast< RawByteArray< Base > * >( compo_vec[ 0 ] ) )			// For the variable this has to be RawByteArray
-								return byte_arr->GetContainer()[ 0 ] == 16 ? EIntCompBase::kHex : EIntCompBase::kDec;
+			const auto kEnd { word.data() + word.size() };
+
+			auto digits { word.data() };
+			const bool kNegative { digits != kEnd && * digits == '-' };
+			if( digits != kEnd && ( * digits == '-' || * digits == kPlus ) )
+				++ digits;
+
+			if( base == kHex && kEnd - digits > 2 && digits[ 0 ] == '0' && ( digits[ 1 ] == 'x' || digits[ 1 ] == 'X' ) )
+				digits += 2;
+
+			// Convert the magnitude as unsigned, so the full cell range, such as 0xFFFFFFFFFFFFFFFF, is also allowed
+			if( CellType magnitude {}; digits != kEnd && * digits != '-' && * digits != kPlus )
+				if( const auto [ ptr, ec ] = std::from_chars( digits, kEnd, magnitude, base ); ptr == kEnd )
+				{
+					if( ec == std::errc::result_out_of_range || ( kNegative && magnitude > static_cast< CellType >( std::numeric_limits< SignedIntType >::max() ) + 1 ) )
+						throw ForthError( "integer literal out of range - " + word );
+
+					if( ec == std::errc() )
+						return { ENumberKind::kInteger, BlindValueReInterpretation< SignedIntType >( kNegative ? CellType() - magnitude : magnitude ) };
+				}
 
 
-			return EIntCompBase::kDec;			// this is the default value
+			if( word.find( '.' ) == Name::npos )
+				return {};
+
+			// from_chars does not accept the leading +
+			const auto kFirst { word.data() + ( word.size() > 0 && word[ 0 ] == kPlus ? 1 : 0 ) };
+			if( kFirst == kEnd || * kFirst == kPlus || ( * kFirst == '-' && word.data() != kFirst ) )
+				return {};
+
+#if defined( __cpp_lib_to_chars )
+			if( FloatType val {}; std::from_chars( kFirst, kEnd, val ).ptr == kEnd )
+				return { ENumberKind::kFloatingPt, {}, val };
+#else
+			if( Letter * ptr {}; std::strtod( kFirst, & ptr ), ptr == kEnd )		// a fallback for libraries with no floating-point from_chars
+				return { ENumberKind::kFloatingPt, {}, std::strtod( kFirst, nullptr ) };
+#endif
+
+			return {};
 		}
 
-	protected:
 
-		auto Word_2_Integer( const Name & word )
+		// The interpreter resolves each token once and then caches its meaning, so that a repeated token costs 
+		// just one hash probe. Only the context words, such as FIND or CREATE, go each time the full way.
+		enum class ETokenKind { kContext, kWord, kDefiningWord, kNumber };
+
+		struct TResolvedToken
 		{
-			try
-			{
-				return std::stoll( word, nullptr, ReadTheBase() );
-			}
-			catch( ... )
-			{
-				throw ForthError( "wrong format of the integer literal" );
-			}
-		}
+			ETokenKind		fKind { ETokenKind::kContext };
+			WordPtr			fWordPtr {};		// for kWord and kDefiningWord
+			TNumber			fNumber {};			// for kNumber
+			EIntCompBase	fNumberBase {};		// the BASE the number was converted in
+		};
+
+		using TokenCache = std::unordered_map< Name, TResolvedToken >;
+
+		static constexpr size_type kTokenCacheMaxSize { 4096 };		// when reached, the cache is cleared (e.g. on a long stream of distinct numbers)
+
+		TokenCache		fTokenCache;
+		size_type		fTokenCacheGeneration {};		// the cache is valid only for this generation of the dictionary
 
 
-		bool IsInteger( const Name & n, EIntCompBase expected_base )
+		// Returns the cached meaning of the token, or nullptr if it needs to be resolved
+		const TResolvedToken * FindResolvedToken( const Name & token )
 		{
-			switch( expected_base )
+			if( fTokenCacheGeneration != GetDictGeneration() )
+				return nullptr;
+
+			if( const auto pos = fTokenCache.find( token ); pos != fTokenCache.end() )
+				if( pos->second.fKind != ETokenKind::kNumber || pos->second.fNumberBase == ReadTheBase() )
+					return & pos->second;
+
+			return nullptr;
+		}
+
+		void CacheResolvedToken( const Name & token, const TResolvedToken & resolved )
+		{
+			if( fTokenCacheGeneration != GetDictGeneration() || fTokenCache.size() >= kTokenCacheMaxSize )
 			{
-				case kDec: return std::regex_match( n, kIntVal );
-				case kHex: return std::regex_match( n, kHexIntVal );
-				default: assert( ! "not supported formats" ); break;
+				fTokenCache.clear();
+				fTokenCacheGeneration = GetDictGeneration();
 			}
 
-			return false;
+			fTokenCache.insert_or_assign( token, resolved );
 		}
 
 
-		bool IsFloatingPt( const Name & n )
+		// A view of the not yet consumed tokens of a line. The tokens are consumed just by moving 
+		// the cursor, so a line of any length is processed in linear time.
+		class TokenCursor
 		{
-			return std::regex_match( n, kFloatPtVal );
-		}
+			Names &		fNames;
+			size_type	fPos {};
+
+		public:
+
+			TokenCursor( Names & ns ) : fNames( ns ) {}
+
+			// The number of the tokens left
+			size_type size( void ) const { return fNames.size() - fPos; }
 
+			// The i-th token counting from the cursor
+			Name & operator [] ( const size_type i ) { assert( i < size() ); return fNames[ fPos + i ]; }
 
+			void Skip( const size_type n ) { assert( n <= size() ); fPos += n; }
 
-		void Erase_n_First_Words( Names & ns, const Names::size_type to_remove )
+			// The number of the already consumed tokens, which is kept in >IN
+			size_type	GetPosition( void ) const { return fPos; }
+			void		SetPosition( const size_type pos ) { fPos = std::min( pos, fNames.size() ); }
+
+			// Puts the token in front of the remaining ones - there is a place since at least one has been consumed
+			void PushFront( Name n ) { assert( fPos > 0 ); fNames[ -- fPos ] = std::move( n ); }
+		};
+
+
+		void Erase_n_First_Words( TokenCursor & ns, const size_type to_remove )
 		{
-			ns.erase( ns.begin(), ns.begin() + to_remove );
+			ns.Skip( to_remove );
 		}
 
 	protected:
@@ -136,7 +232,7 @@ namespace BCForth
 
 
 		// Allows for recursive (nested) enclosings
-		auto CollectTextUpToTokenContaining( Names & ns, const Letter enter_letter, const Letter close_letter )
+		auto CollectTextUpToTokenContaining( TokenCursor & ns, const Letter enter_letter, const Letter close_letter )
 		{
 			Name str;
 
@@ -148,6 +244,15 @@ namespace BCForth
 				const auto token { ns[ 0 ] };		// at each iteration take the first word
 				Erase_n_First_Words( ns, 1 );		// immediately, remove from the stream
 
+				// The text goes on in the next line (the reader marks the line break with this token)
+				if( token == kCR )
+				{
+					if( str.length() > 0 && str.back() == kSpace )
+						str.pop_back();
+					str += kCR;
+					continue;
+				}
+
 				if( const auto pos = ContainsSubstrAt( token, enter_letter ) ; pos != Name::npos )
 				{
 					// If here, then we encountered the nested definition (i.e. parenthesis inside parenthesis), so we need to match them
@@ -162,7 +267,7 @@ namespace BCForth
 						// a closing symbol found - split, left attach, right treat as a new token
 						const auto & [ s0, s1 ] = SplitAt( token, pos + 1 );		
 						str += s0;
-						ns.insert( ns.begin(), s1 );	// insert new token to the stream
+						ns.PushFront( s1 );				// insert new token to the stream
 					}
 
 				}
@@ -202,7 +307,7 @@ namespace BCForth
 
 		// Process and consume the processed words (i.e. these will be erased from the input stream)
 		// ns will be modified
-		virtual void ProcessContextSequences( Names & ns )
+		virtual void ProcessContextSequences( TokenCursor & ns )
 		{
 			const auto kNumNames { ns.size() };
 			if( kNumNames == 0 )
@@ -219,7 +324,7 @@ namespace BCForth
 					throw ForthError( "Syntax missing word name" );
 
 				if( auto word_entry = GetWordEntry( ns[ 1 ] ); word_entry )
-					cout << "Word " << ns[ 1 ] << " found ==> ( " << ( * word_entry )->fWordComment << " )" << ( ( * word_entry )->fWordIsImmediate ? "\t\timmediate" : "" ) << endl;
+					cout << "Word " << ns[ 1 ] << " found ==> ( " << GetWordComment( ** word_entry ) << " )" << ( ( * word_entry )->fWordIsImmediate ? "\t\timmediate" : "" ) << endl;
 				else
 					cout << "Unknown word " << ns[ 1 ] << endl;
 
@@ -228,6 +333,65 @@ namespace BCForth
 			}
 
 
+			// VOCABULARY NAME - creates a new wordlist and the word NAME, which puts it on the top of the search order
+			if( leadName == "VOCABULARY" )
+			{
+				// There should be a following name for that vocabulary
+				if( kNumNames <= 1 )
+					throw ForthError( "Syntax missing vocabulary name" );
+
+				InsertVocabulary_2_Dict( ns[ 1 ] );
+
+				Erase_n_First_Words( ns, 2 );
+				return;
+			}
+
+
+			// MARKER NAME - creates the word NAME, which removes itself and all the words defined after it
+			if( leadName == "MARKER" )
+			{
+				// There should be a following name for that marker
+				if( kNumNames <= 1 )
+					throw ForthError( "Syntax missing marker name" );
+
+				InsertWord_2_Dict( ns[ 1 ], MakeWord< Marker< TForth > >( * this, GetDictMark() ), " -- ==> forget this and all later words " );
+
+				Erase_n_First_Words( ns, 2 );
+				return;
+			}
+
+
+			// REQUIRE-MODULE NAME - makes the words of the module at once, rather than on the first call of one of them
+			if( leadName == "REQUIRE-MODULE" )
+			{
+				// There should be a following name for that module
+				if( kNumNames <= 1 )
+					throw ForthError( "Syntax missing module name" );
+
+				RequireModule( ns[ 1 ] );
+
+				Erase_n_First_Words( ns, 2 );
+				return;
+			}
+
+
+			// FORGET NAME - removes NAME and all the words defined after it
+			if( leadName == "FORGET" )
+			{
+				// There should be a following name for that word
+				if( kNumNames <= 1 )
+					throw ForthError( "Syntax missing word name" );
+
+				if( auto word_entry = GetWordEntry( ns[ 1 ] ) )
+					RewindDict( GetDictMarkOf( ** word_entry ) );
+				else
+					throw ForthError( "unknown word - " + ns[ 1 ] );
+
+				Erase_n_First_Words( ns, 2 );
+				return;
+			}
+
+
 			// ' DUP
 			if( leadName == "'" )
 			{
@@ -302,57 +466,119 @@ namespace BCForth
 		}
 
 
-		// The main entry to the Forth's INTERPRETER
-		virtual void ExecuteWords( Names && ns )
+		// The main entry to the Forth's INTERPRETER - the words are processed in a loop, 
+		// each consumed by moving the cursor
+		virtual void ExecuteWords( TokenCursor & ns )
 		{
+			while( ns.size() > 0 )
+			{
+				// The fast path - a word or a number which has been already resolved
+				if( const auto * resolved = FindResolvedToken( ns[ 0 ] ) )
+				{
+					if( resolved->fKind == ETokenKind::kWord )
+					{
+						const auto wp { resolved->fWordPtr };		// copy, since the word can change the cache
+						LogRun( ns[ 0 ] );
+						Erase_n_First_Words( ns, 1 );
+						ExecuteWord( wp, ns );
+						continue;
+					}
 
-			ProcessContextSequences( ns );
+					if( resolved->fKind == ETokenKind::kNumber )
+					{
+						PushNumber( resolved->fNumber );
+						Erase_n_First_Words( ns, 1 );
+						continue;
+					}
 
-			const auto kNumNames { ns.size() };
-			if( kNumNames == 0 )
-				return;
+					if( resolved->fKind == ETokenKind::kDefiningWord && ProcessDefiningWord( ns[ 0 ], ns ) )
+					{
+						LogRun( ns[ 0 ] );
+						Erase_n_First_Words( ns, 2 );	// get rid of the already consumed words
+						continue;
+					}
+				}
 
-			const auto & word { ns[ 0 ] };
 
+				const auto kNumNamesBefore { ns.size() };
+				const Name lead_token { ns[ 0 ] };
 
-			if( IsInteger( word, ReadTheBase() ) )
-			{
-				GetDataStack().Push( Word_2_Integer( word ) );
-				Erase_n_First_Words( ns, 1 );	// get rid of the already consumed word
-				ExecuteWords( std::move( ns ) );
-				return;
-			}
+				ProcessContextSequences( ns );
 
+				if( ns.size() != kNumNamesBefore || ( ns.size() > 0 && ns[ 0 ] != lead_token ) )
+				{
+					LogRun( lead_token );
+					CacheResolvedToken( lead_token, { ETokenKind::kContext } );
+					continue;		// something consumed, so the next token can also start a context sequence (e.g. : after ;)
+				}
 
-			if( IsFloatingPt( word ) )
-			{
-				GetDataStack().Push( BlindValueReInterpretation< CellType >( stod( word ) ) );		// for now, later we need to devise something better for floats
-				Erase_n_First_Words( ns, 1 );	// get rid of the already consumed word
-				ExecuteWords( std::move( ns ) );
-				return;
-			}
 
+				const auto & word { ns[ 0 ] };
 
-			if( ProcessDefiningWord( word, ns ) )
-			{
-				Erase_n_First_Words( ns, 2 );	// get rid of the already consumed words
-				ExecuteWords( std::move( ns ) );
-				return;
-			}
 
+				// Check if a registered word and execute
+				if( const auto word_entry = GetWordEntry( word ) )
+				{
+					const auto wp { ( * word_entry )->fWordUP.get() };
+					const auto is_defining { ( * word_entry )->fWordIsDefining };
 
-			// Check if a registered word and execute
-			if( ExecWord( word ) )
-			{
+					CacheResolvedToken( word, { is_defining ? ETokenKind::kDefiningWord : ETokenKind::kWord, wp } );
+
+					LogRun( word );
+
+					if( is_defining && ProcessDefiningWord( word, ns ) )
+					{
+						Erase_n_First_Words( ns, 2 );	// get rid of the already consumed words
+						continue;
+					}
+
+					Erase_n_First_Words( ns, 1 );	// get rid of the already consumed word
+					ExecuteWord( wp, ns );
+					continue;
+				}
+
+
+				// Only if not in the dictionary, then it can be a number
+				const auto base { ReadTheBase() };
+				const auto number { Word_2_Number( word, base ) };
+				if( number.fKind == ENumberKind::kNotANumber )
+					throw ForthError( "unknown word - " + word );
+
+				CacheResolvedToken( word, { ETokenKind::kNumber, {}, number, base } );
+
+				PushNumber( number );
 				Erase_n_First_Words( ns, 1 );	// get rid of the already consumed word
-				ExecuteWords( std::move( ns ) );
-				return;
 			}
+		}
+
+
+		// The executed word can move the position in the line by changing >IN
+		void ExecuteWord( const WordPtr wp, TokenCursor & ns )
+		{
+			auto & to_in { GetSystemVars().fToIn };
+			to_in = ns.GetPosition();
+
+			( * wp )();
+
+			RewindDictIfRequested();		// e.g. the word was a MARKER
+
+			if( to_in != ns.GetPosition() )
+				ns.SetPosition( to_in );
+		}
+
+
+		void PushNumber( const TNumber & number )
+		{
+			bool pushed {};
+			if( number.fKind == ENumberKind::kInteger )
+				pushed = GetDataStack().Push( BlindValueReInterpretation< CellType >( number.fIntVal ) );
+			else if( HasFloatStack() )
+				pushed = GetFloatStack().Push( number.fFloatVal );
 			else
-			{
-				throw ForthError( "unknown word - " + word );
-			}
+				pushed = GetDataStack().Push( BlindValueReInterpretation< CellType >( number.fFloatVal ) );
 
+			if( ! pushed )
+				throw ForthError( "stack overflow" );
 		}
 
 
@@ -360,7 +586,7 @@ namespace BCForth
 
 
 		// The one created with DOES>
-		virtual bool ProcessDefiningWord( const Name & word_name, const Names & ns )
+		virtual bool ProcessDefiningWord( const Name & word_name, TokenCursor & ns )
 		{
 			// First, check if this is a defining word
 			if( auto word_entry = GetWordEntry( word_name ); word_entry && (*word_entry)->fWordIsDefining )
@@ -397,14 +623,18 @@ namespace BCForth
 
 
 							// Create a new entry with connected behavioral branch
-							auto definedWord { std::make_unique< CompoWord< TForth > >( * this ) };
+							auto definedWord { MakeWord< CompoWord< TForth > >( * this ) };
 							auto definedWordPtr { definedWord.get() };
 
 							definedWordPtr->AddWord( arr_wrd );								// (1) Connect the RawByteArray word - whenever called it will leave the address of its data 
 							if( ! IsEmpty( does_wrd->GetBehaviorNode() ) )
 								definedWordPtr->AddWord( & does_wrd->GetBehaviorNode() );	// (2) Connect the behavioral branch, as already pre-defined in the defining word
 
-							InsertWord_2_Dict( ns[ 1 ], std::move( definedWord ) );		// Now we have fully created new word in the dictionary		
+							// Only the words made by VALUE are marked as such, so TO does not store to a CONSTANT or a VARIABLE
+							const auto value_entry { GetWordEntry( "VALUE" ) };
+							const bool is_value { value_entry && * value_entry == * word_entry && arr_wrd->GetData().size() == sizeof( CellType ) };
+
+							InsertWord_2_Dict( ns[ 1 ], std::move( definedWord ), "", false, false, false, is_value );		// Now we have fully created new word in the dictionary		
 
 							return true;
 						}
@@ -437,7 +667,8 @@ namespace BCForth
 		// Process a stream of tokens
 		virtual void operator() ( Names && ns )
 		{
-			ExecuteWords( std::move( ns ) );
+			TokenCursor tc( ns );
+			ExecuteWords( tc );
 		}
 
 	public:
@@ -447,6 +678,8 @@ namespace BCForth
 		{
 			GetDataStack().clear();
 			GetRetStack().clear();	
+			SetLocalsFrame( 0 );
+			CancelDictRewind();
 		}
 
 
@@ -22,6 +22,11 @@
 #include "CoreModule.h"
 #include "RandModule.h"
 #include "TimeModule.h"
+#include <chrono>
+
+#ifdef BCFORTH_BUILTIN_IMAGE
+#include "BuiltinImage.h"		// generated at build time by tools/MakeBuiltinImage.cpp
+#endif
 
 
 
@@ -62,32 +67,157 @@ All operations on the stack in the Reverse Polish Notation
 
 
 
-	void Run( void )
+	// Where the text definitions are read from when there is no built-in image
+	// (CMake passes the absolute path, so the program can be run from any directory)
+#ifndef BCFORTH_ADDONS_PATH
+#define BCFORTH_ADDONS_PATH "../add_ons/AddOns.txt"
+#endif
+
+
+	// The words written in C++ go first - "a must" and the extra modules
+	// Some go to their own wordlists, which are all in the search order (ONLY FORTH hides them)
+	void LoadNativeModules( TForthCompiler & F_compiler )
+	{
+		CoreEncodedWords()( F_compiler );
+		AuxStackWords()( F_compiler );
+		LazyWordListModule( "FLOATING", FP_Module() )( F_compiler );		// these are made on their first use
+		LazyWordListModule( "STRINGS", StringModule() )( F_compiler );
+		LazyWordListModule( "RANDOM", RandomModule() )( F_compiler );
+		LazyWordListModule( "TIMING", TimeModule() )( F_compiler );
+
+		F_compiler.SetNativeDefs();
+	}
+
+	// Then the words defined in Forth - order matters (words depend on previous words)
+	void LoadTextModules( TForthCompiler & F_compiler, const Name & addons_path = BCFORTH_ADDONS_PATH )
+	{
+		CoreDefinedWords()( F_compiler );
+		AuxTextModule()( F_compiler );
+
+		FileForthModule { addons_path }( F_compiler );	// new definitions can be added to the text file AddOns.txt
+
+		F_compiler.SetDictFence();		// FORGET cannot go below this
+	}
+
+
+	// The command line options
+	struct TRunOptions
+	{
+		Name	fImagePath;		// --image path - start with the words of the image, rather than compile them
+
+		std::optional< Name >	fCacheDir;		// --cache-dir path - where INCLUDE and REQUIRE keep the compiled files (--no-cache - nowhere)
+
+		std::vector< fs::path >	fSourceFiles;	// the other arguments - loaded at the start, in this order
+		unsigned				fNumJobs { std::max( std::thread::hardware_concurrency(), 1u ) };	// --jobs n - the threads which tokenize them
+
+		size_type	fDataStackCells { TForth::kStackMaxCells };		// --stack-cells n - the capacity of the data stack
+		size_type	fRetStackCells { TForth::kStackMaxCells };		// --rstack-cells n - and of the return stack
+		size_type	fFloatStackCells {};							// --fstack-cells n - the floats go to their own stack (0 - they share the data stack)
+		size_type	fDataSpaceBytes { TForth::kDataSpaceBytes };	// --data-bytes n - the reserved data space (CREATE, ALLOT, , etc.)
+	};
+
+
+	TRunOptions ParseRunOptions( int argc, char ** argv )
+	{
+		TRunOptions options;
+
+		for( int i { 1 }; i < argc; ++ i )
+		{
+			if( const Name arg { argv[ i ] }; arg == "--image" && i + 1 < argc )
+				options.fImagePath = argv[ ++ i ];
+			else if( arg == "--cache-dir" && i + 1 < argc )
+				options.fCacheDir = argv[ ++ i ];
+			else if( arg == "--no-cache" )
+				options.fCacheDir = Name();
+			else if( arg == "--jobs" && i + 1 < argc )
+				options.fNumJobs = static_cast< unsigned >( std::max( std::atoi( argv[ ++ i ] ), 1 ) );
+			else if( arg == "--stack-cells" && i + 1 < argc )
+				options.fDataStackCells = std::max< size_type >( std::strtoull( argv[ ++ i ], nullptr, 10 ), 1 );
+			else if( arg == "--rstack-cells" && i + 1 < argc )
+				options.fRetStackCells = std::max< size_type >( std::strtoull( argv[ ++ i ], nullptr, 10 ), 1 );
+			else if( arg == "--fstack-cells" && i + 1 < argc )
+				options.fFloatStackCells = std::strtoull( argv[ ++ i ], nullptr, 10 );
+			else if( arg == "--data-bytes" && i + 1 < argc )
+				options.fDataSpaceBytes = std::strtoull( argv[ ++ i ], nullptr, 10 );
+			else if( arg.starts_with( "--" ) )
+				std::cerr << "Unknown option: " << arg << endl;
+			else
+				options.fSourceFiles.emplace_back( arg );
+		}
+
+		return options;
+	}
+
+
+
+	void Run( const TRunOptions & options = TRunOptions() )
 	{
 		std::cout << kWelcomeString;
 
 
 		bool exit_flag { false };
 
-		TForthCompiler	F_compiler;
+		TForthCompiler	F_compiler( options.fDataStackCells, options.fRetStackCells, options.fFloatStackCells, options.fDataSpaceBytes );
 		TForthReader	theReader;
 
 
 
-		// This is "a must"
-		CoreEncodedWords()( F_compiler );
-		CoreDefinedWords()( F_compiler );
+		LoadNativeModules( F_compiler );
 
+		if( options.fCacheDir )
+			F_compiler.GetSourceCache().SetCacheDir( * options.fCacheDir );
 
-		// Load extra modules - order matters (words depend on previous words)
-		AuxStackWords()( F_compiler );
-		FP_Module()( F_compiler );
-		AuxTextModule()( F_compiler );
-		StringModule()( F_compiler );
-		RandomModule()( F_compiler );
-		TimeModule()( F_compiler );
+		if( options.fImagePath.empty() )
+		{
+#ifdef BCFORTH_BUILTIN_IMAGE
+			// The words defined in Forth were compiled at build time - no parsing at the start
+			try
+			{
+				TForthImageFor< TForthCompiler >( F_compiler ).Load( kBuiltinImage, sizeof( kBuiltinImage ), "(built-in)" );
+			}
+			catch( const ForthError & err )
+			{
+				std::cerr << "\nError: " << err.what() << endl;
+				return;
+			}
+#else
+			LoadTextModules( F_compiler );
+#endif
+		}
+		else
+		{
+			// The image made with SAVE-IMAGE holds them all (and its own fence)
+			try
+			{
+				const auto start { std::chrono::steady_clock::now() };
+				TForthImageFor< TForthCompiler >( F_compiler ).Load( options.fImagePath );
+				const std::chrono::duration< double, std::milli > elapsed { std::chrono::steady_clock::now() - start };
 
-		FileForthModule( "../add_ons/AddOns.txt" )( F_compiler );	// new definitions can be added to the text file AddOns.txt
+				std::cout << "Image " << options.fImagePath << " loaded in " << elapsed.count() << " ms" << endl;
+			}
+			catch( const ForthError & err )
+			{
+				std::cerr << "\nError: " << err.what() << endl;
+				return;
+			}
+		}
+
+		if( ! options.fSourceFiles.empty() )
+		{
+			try
+			{
+				const auto start { std::chrono::steady_clock::now() };
+				SourceFilesModule( options.fSourceFiles, options.fNumJobs )( F_compiler );
+				const std::chrono::duration< double, std::milli > elapsed { std::chrono::steady_clock::now() - start };
+
+				std::cout << options.fSourceFiles.size() << " file(s) loaded in " << elapsed.count() << " ms (" << options.fNumJobs << " jobs)" << endl;
+			}
+			catch( const ForthError & err )
+			{
+				F_compiler.CleanUpAfterRunTimeError();
+				std::cerr << "\nError: " << err.what() << endl;		// the files after this one are not loaded
+			}
+		}
 
 
 
@@ -102,7 +232,8 @@ All operations on the stack in the Reverse Polish Notation
 
 					auto tokens { theReader( std::cin ) };
 
-					if( SystemProcessTokens( F_compiler, tokens, exit_flag ) == false )
+					// The system words are not checked inside an open definition (it can have e.g. EXIT in its next lines)
+					if( F_compiler.IsCompiling() || SystemProcessTokens( F_compiler, tokens, exit_flag ) == false )
 						F_compiler( std::move( tokens ) );	
 
 				}
@@ -161,6 +292,7 @@ All operations on the stack in the Reverse Polish Notation
 				{
 					for( TForthReader fileReader; fs; F_compiler( fileReader( fs ) ) ) 
 						;
+					F_compiler.CheckEndOfSource( forth_source );
 
 					std::cout << "File processed OK\n" << endl;
 				}
@@ -14,6 +14,7 @@
 
 
 #include "BaseDefinitions.h"
+#include <array>
 
 
 
@@ -40,94 +41,131 @@ class TForthReader
 protected:
 
 
-	Name StripEndingComment( Name & ln )
+	// Character classes of the lexer
+	static constexpr auto kBlankTable = [] ()
 	{
-		if( auto pos = ln.find( kBackSlash ); pos != Name::npos )
-			ln.erase( ln.begin() + pos, ln.end() );
+		std::array< bool, 256 > tab {};
+		for( const auto c : { ' ', '\t', '\n', '\r', '\v', '\f' } )
+			tab[ static_cast< unsigned char >( c ) ] = true;
+		return tab;
+	} ();
 
-		return ln;
-	}
+	static constexpr auto kUpperTable = [] ()
+	{
+		std::array< Letter, 256 > tab {};
+		for( auto i { 0 }; i < 256; ++ i )
+			tab[ i ] = static_cast< Letter >( i >= 'a' && i <= 'z' ? i - 'a' + 'A' : i );
+		return tab;
+	} ();
 
+	static constexpr bool IsBlank( const Letter c ) { return kBlankTable[ static_cast< unsigned char >( c ) ]; }
 
-public:
+	static constexpr Letter ToUpper( const Letter c ) { return kUpperTable[ static_cast< unsigned char >( c ) ]; }
 
 
-	// Read a line or lines and return the names
-	virtual Names operator() ( std::istream & i )
+	// The lexer is in one of these modes - the user's text, i.e. the one following ." S" etc. 
+	// or placed in a comment ( ... ), is not converted to the uppercase, nor is a file path
+	enum class ELexMode { kNormal, kQuote, kParen, kPath };
+
+
+	// A single pass over the text which splits it into the nonempty tokens on any blanks, appended to outNames.
+	// If CaseInsensitive, then the tokens are converted to the uppercase on the fly, except the user's text.
+	// Returns the mode at the end of the text, i.e. not kNormal if a text or a comment is still open.
+	ELexMode Tokenize( const Name & text, Names & outNames, ELexMode mode = ELexMode::kNormal )
 	{
+		for( auto pos { text.data() }, end { text.data() + text.size() }; ; )
+		{
+			while( pos != end && IsBlank( * pos ) )
+				++ pos;
 
-		Name lines;
+			if( pos == end )
+				break;
 
-		// This is a simple state machine:
-		//		Take the first line and check if it beginns with the colon (i.e. it is a word definition);
-		//			If so, then read all lines up and including the one that contains a semicolon (i.e. a word end).
-		//		If no colon, then it is a word call
+			// Find the end of the token, and on the way check for the closing letters
+			const auto tok_begin { pos };
+			bool has_quote { false }, has_right_paren { false };
+			for( ; pos != end && ! IsBlank( * pos ); ++ pos )
+				has_quote |= * pos == kQuote, has_right_paren |= * pos == kRightParen;
 
+			auto & token { outNames.emplace_back( tok_begin, pos ) };
 
-		if( Name ln; std::getline( i, ln ) )
-		{
-			lines = StripEndingComment( ln );
+			switch( mode )
+			{
+				case ELexMode::kNormal:
 
-			if( auto pos = ln.find_first_not_of( kBlanks ); pos != Name::npos && ln[ pos ] == kColon )
-				while( ln.find( kSemColon, pos ) == Name::npos && std::getline( i, ln )  )		// read new lines until a one with ; is found
-					lines += kCR + StripEndingComment( ln );		// add CR since getline swallows it
+					if constexpr( CaseInsensitive )
+						for( auto & c : token )
+							c = ToUpper( c );
 
-		}
+					if( token == kDotQuote || token == kCommaQuote || token == kAbortQuote || token == kCQuote || token == kSQuote )
+						mode = ELexMode::kQuote;
+					else if( token.length() == 1 && token[ 0 ] == kLeftParen )
+						mode = ELexMode::kParen;
+					else if( token == kSaveImage || token == kInclude || token == kRequire )
+						mode = ELexMode::kPath;
 
-		// Split all these into the nonempty tokens
-		Names outNames;
-		std::copy_if(	std::sregex_token_iterator( lines.cbegin(), lines.cend(), kBlanksRe, -1 ), std::sregex_token_iterator(), 
-						std::back_inserter( outNames ), [] ( const auto & s ) { return s.length() > 0; } );
+					break;
 
+				case ELexMode::kQuote:
 
+					if( has_quote )
+						mode = ELexMode::kNormal;		// the closing " can be glued to the end of a text
+					break;
 
-		if constexpr( CaseInsensitive )
-		{
+				case ELexMode::kParen:
 
-			// Toggle cur_skip_flag on discovering inStr in n or outStr in n
-			// cur_skip_flag == true means we are in the special "don't case change" mode
-			// returned true means we enter the "special' mode
-			auto assessSkipFlag = [] ( bool cur_skip_flag, const Name & n, const Name & inStr, const Name & outStr ) {
+					if( has_right_paren )
+						mode = ELexMode::kNormal;
+					break;
 
-				if( cur_skip_flag == false && n == inStr )		// Toggle flag - to prevent entering for the second inStr
-					return true;
-				else
-					if( cur_skip_flag == true && ContainsSubstrAt( n, outStr ) != Name::npos )
-						return false;
+				case ELexMode::kPath:
 
-				return cur_skip_flag;
-			};
+					mode = ELexMode::kNormal;		// only one token, in the same line
+					break;
+			}
 
+		}
 
+		return mode;
+	}
 
-			// Here we convert each token to the UPPERCASE, however there are exceptions (e.g. the user entered text)
-			for( bool skip_flags [] = { false, false }; auto & n : outNames )		// convert all to uppercase
-			{
 
-				if( skip_flags[ 0 ] == false && skip_flags[ 1 ] == false )
-					std::transform( n.begin(), n.end(), n.begin(), [] ( const auto c ) { return static_cast< Char >( std::toupper( c ) ); } );
+	Name & StripEndingComment( Name & ln )
+	{
+		if( auto pos = ln.find( kBackSlash ); pos != Name::npos )
+			ln.erase( ln.begin() + pos, ln.end() );
 
-				if( skip_flags[ 1 ] == false )															// Find first such that
-					for( auto prev_skip_flag_0 { skip_flags[ 0 ] }; const auto & specModeEnterToken : { kDotQuote, kCommaQuote, kAbortQuote, kCQuote, kSQuote } )
-						if( prev_skip_flag_0 ^ ( skip_flags[ 0 ] = assessSkipFlag( skip_flags[ 0 ], n, specModeEnterToken, Name( 1, kQuote ) ) ) )
-							break;	// if there was a toggle from the "spec mode" to the "normal one", or vice versa, then do NOT check anything more (to prevent checking the "trigerring" token twice, such as ,")
+		return ln;
+	}
 
 
-				if( skip_flags[ 0 ] == false )
-					skip_flags[ 1 ] = assessSkipFlag( skip_flags[ 1 ], n, Name( 1, kLeftParen ), Name( 1, kRightParen ) );
+public:
 
-			}
 
-		}
+	// Read a line and return its names. The reader does not gather the whole definitions - 
+	// these are compiled line after line, so the memory does not grow with the size of the source.
+	// Only a text or a comment which is not closed in this line is continued with the next one(s) - 
+	// the line break of a text is kept as the kCR token.
+	virtual Names operator() ( std::istream & i )
+	{
+		Names outNames;
 
+		for( auto mode { ELexMode::kNormal }; std::getline( i, fLine ); )
+		{
+			if( mode = Tokenize( StripEndingComment( fLine ), outNames, mode ); mode == ELexMode::kNormal || mode == ELexMode::kPath )
+				break;		// a path is not looked for in the next line (the word without it is reported)
 
+			if( mode == ELexMode::kQuote )
+				outNames.push_back( kCR );
+		}
 
 		return outNames;
-
 	}
 
 
+private:
 
+	Name	fLine;		// the line buffer, reused by the consecutive reads
 
 };
 
@@ -14,7 +14,7 @@
 
 
 #include "Modules.h"
-
+#include "Primitives.h"
 
 
 
@@ -41,126 +41,161 @@ namespace BCForth
 		{
 
 
-			forth_comp.InsertWord_2_Dict( ".",		std::make_unique< Dot< TForth, SignedIntType > >( forth_comp, forth_comp.GetOutStream() ), " x -- " );
-			forth_comp.InsertWord_2_Dict( ".S",		std::make_unique< Dot_S< TForth, SignedIntType > >( forth_comp, forth_comp.GetOutStream() ), " x -- x " );
-
-
-			forth_comp.InsertWord_2_Dict( ".SD",	std::make_unique< Stack_Dump< TForth, SignedIntType > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kSpace ) ), " x -- x ==> int stack dump " );
-			forth_comp.InsertWord_2_Dict( ".SDU",	std::make_unique< Stack_Dump< TForth, CellType > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kSpace ) ), " x -- x ==> uint stack dump " );
-
-
-
+			forth_comp.InsertWord_2_Dict( ".",		MakeWord< Dot< TForth, SignedIntType > >( forth_comp, forth_comp.GetOutStream() ), " x -- " );
+			forth_comp.InsertWord_2_Dict( ".S",		MakeWord< Dot_S< TForth, SignedIntType > >( forth_comp, forth_comp.GetOutStream() ), " x -- x " );
+			forth_comp.InsertWord_2_Dict( "D.",		MakeWord< D_Dot< TForth > >( forth_comp, forth_comp.GetOutStream() ), " d -- " );
 
-			forth_comp.InsertWord_2_Dict( "DROP",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Drop();  }	 > >( forth_comp ), " x -- " );
-			forth_comp.InsertWord_2_Dict( "DUP",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Dup();  }	 > >( forth_comp ), " x -- x x " );
-			forth_comp.InsertWord_2_Dict( "SWAP",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Swap();  }	 > >( forth_comp ), " x y -- y x " );
-			forth_comp.InsertWord_2_Dict( "OVER",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Over();  }	 > >( forth_comp ), " x y -- x y x " );
-			forth_comp.InsertWord_2_Dict( "ROT",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Rot();  }	 > >( forth_comp ), " x y z -- y z x " );
 
+			forth_comp.InsertWord_2_Dict( ".SD",	MakeWord< Stack_Dump< TForth, SignedIntType > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kSpace ) ), " x -- x ==> int stack dump " );
+			forth_comp.InsertWord_2_Dict( ".SDU",	MakeWord< Stack_Dump< TForth, CellType > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kSpace ) ), " x -- x ==> uint stack dump " );
 
-			forth_comp.InsertWord_2_Dict( "+",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Plus< SignedIntType >();  }	 > >( forth_comp ), " x y -- x+y " );
-			forth_comp.InsertWord_2_Dict( "-",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Minus< SignedIntType >();  }	 > >( forth_comp ), " x y -- x-y " );
-			forth_comp.InsertWord_2_Dict( "*",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Mult< SignedIntType >();  }	 > >( forth_comp ), " x y -- x*y " );
-			forth_comp.InsertWord_2_Dict( "/",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Div< SignedIntType >();  }	 > >( forth_comp ), " x y -- x/y " );
-			forth_comp.InsertWord_2_Dict( "MOD",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Mod< SignedIntType >();  }	 > >( forth_comp ), " x y -- x/y " );
 
+			// The stack, arithmetic, logical and memory operations - all are described in kPrimitives
+			InsertPrimitives_2_Dict( forth_comp );
 
 
-			using UnarySignOp = StackOp< TForth, SignedIntType, SignedIntType >;
-			using BinSignOp = StackOp< TForth, SignedIntType, SignedIntType, SignedIntType >;
+			forth_comp.InsertWord_2_Dict( "CR",		MakeWord< DotQuote< TForth > >( forth_comp, forth_comp.GetOutStream(), kCR ) );
+			forth_comp.InsertWord_2_Dict( "TAB",	MakeWord< DotQuote< TForth > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kTab ) ) );
+			forth_comp.InsertWord_2_Dict( "SPACE",	MakeWord< DotQuote< TForth > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kSpace ) ) );
 
-			forth_comp.InsertWord_2_Dict( "NEG",	std::make_unique< UnarySignOp >( forth_comp, [] ( const auto x ) { return -x; } ), " x -- -x " );
 
+			forth_comp.InsertWord_2_Dict( "CREATE",	MakeWord< Create< TForth > >( forth_comp ), " -- " );
+			forth_comp.InsertWord_2_Dict( "ALLOT",	MakeWord< Allot< TForth > >( forth_comp ), " n_bytes -- " );
+			forth_comp.InsertWord_2_Dict( ",",		MakeWord< Comma< TForth, CellType > >( forth_comp ), " x -- " );
+			forth_comp.InsertWord_2_Dict( "C,",		MakeWord< Comma< TForth, RawByte > >( forth_comp ), " c -- " );
 
-			forth_comp.InsertWord_2_Dict( "AND",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.And();  }	 > >( forth_comp ), " x y -- x_AND_y " );
-			forth_comp.InsertWord_2_Dict( "OR",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Or();  }	 > >( forth_comp ), " x y -- x_OR_y " );
-			forth_comp.InsertWord_2_Dict( "XOR",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Xor();  }	 > >( forth_comp ), " x y -- x_XOR_y " );
-			forth_comp.InsertWord_2_Dict( "~",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Neg();  }	 > >( forth_comp ), " x -- BIT_INV(x) " );
+			// The data space - all CREATEd data lie in it one after another
+			forth_comp.InsertWord_2_Dict( "HERE",	MakeWord< StackOp< TForth, CellType > >( forth_comp, [ & forth_comp ] () { return reinterpret_cast< CellType >( forth_comp.GetDataSpace().Here() ); } ), " -- addr " );
+			forth_comp.InsertWord_2_Dict( "ALIGN",	MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () { forth_comp.AlignData(); } ), " -- " );
+			forth_comp.InsertWord_2_Dict( "ALIGNED",MakeWord< StackOp< TForth, CellType, CellType > >( forth_comp, [] ( const CellType addr ) { return ( addr + sizeof( CellType ) - 1 ) / sizeof( CellType ) * sizeof( CellType ); } ), " addr -- a_addr " );
+			forth_comp.InsertWord_2_Dict( "UNUSED",	MakeWord< StackOp< TForth, CellType > >( forth_comp, [ & forth_comp ] () { return static_cast< CellType >( forth_comp.GetDataSpace().Unused() ); } ), " -- n_bytes " );
 
+			forth_comp.InsertWord_2_Dict( "EXECUTE",MakeWord< Execute< TForth > >( forth_comp ), " ex_token -- ? " );
 
+			forth_comp.InsertWord_2_Dict( "PAD",	MakeWord< RawByteArray< TForth > >( forth_comp, k_PAD_Size ), " -- PAD_addr " );
 
-			forth_comp.InsertWord_2_Dict( "CR",		std::make_unique< DotQuote< TForth > >( forth_comp, forth_comp.GetOutStream(), kCR ) );
-			forth_comp.InsertWord_2_Dict( "TAB",	std::make_unique< DotQuote< TForth > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kTab ) ) );
-			forth_comp.InsertWord_2_Dict( "SPACE",	std::make_unique< DotQuote< TForth > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kSpace ) ) );
 
-
-			forth_comp.InsertWord_2_Dict( "CREATE",	std::make_unique< Create< TForth > >( forth_comp ), " -- " );
-			forth_comp.InsertWord_2_Dict( "ALLOT",	std::make_unique< Allot< TForth > >( forth_comp ), " n_bytes -- " );
-			forth_comp.InsertWord_2_Dict( ",",		std::make_unique< Comma< TForth, CellType > >( forth_comp ), " x -- " );
-			forth_comp.InsertWord_2_Dict( "C,",		std::make_unique< Comma< TForth, RawByte > >( forth_comp ), " c -- " );
-
-			forth_comp.InsertWord_2_Dict( "EXECUTE",std::make_unique< Execute< TForth > >( forth_comp ), " ex_token -- ? " );
-
-			forth_comp.InsertWord_2_Dict( "PAD",	std::make_unique< RawByteArray< TForth > >( forth_comp, k_PAD_Size ), " -- PAD_addr " );
+			// The system variables - their addresses are fixed
+			auto & sys_vars { forth_comp.GetSystemVars() };
+			forth_comp.InsertWord_2_Dict( "BASE",	MakeWord< CellValWord< TForth > >( forth_comp, reinterpret_cast< CellType >( & sys_vars.fBase ) ), " -- BASE_addr " );
+			forth_comp.InsertWord_2_Dict( "STATE",	MakeWord< CellValWord< TForth > >( forth_comp, reinterpret_cast< CellType >( & sys_vars.fState ) ), " -- STATE_addr " );
+			forth_comp.InsertWord_2_Dict( ">IN",	MakeWord< CellValWord< TForth > >( forth_comp, reinterpret_cast< CellType >( & sys_vars.fToIn ) ), " -- >IN_addr (counts the tokens of the line) " );
 
 
 
 			// Emit and key
-			forth_comp.InsertWord_2_Dict( "KEY",	std::make_unique< StackOp< TForth, Char > >( forth_comp, [] () { Char c {}; std::cin.get( c ); return c; } ), " -- c " );
-			forth_comp.InsertWord_2_Dict( "EMIT",	std::make_unique< StackOp< TForth, void, Char > >( forth_comp, [ & forth_comp ] ( const auto c ) { forth_comp.GetOutStream() << c; } ), " c -- " );
-			forth_comp.InsertWord_2_Dict( "TYPE",	std::make_unique< StackOp< TForth, void, Char *, CellType > >( forth_comp, [ & forth_comp ] ( const auto addr, const auto len ) { for( auto i{0}; i < len; ++ i ) forth_comp.GetOutStream() << addr[ i ]; } ), " addr len -- " );
+			forth_comp.InsertWord_2_Dict( "KEY",	MakeWord< StackOp< TForth, Char > >( forth_comp, [] () { Char c {}; std::cin.get( c ); return c; } ), " -- c " );
+			forth_comp.InsertWord_2_Dict( "EMIT",	MakeWord< StackOp< TForth, void, Char > >( forth_comp, [ & forth_comp ] ( const auto c ) { forth_comp.GetOutStream() << c; } ), " c -- " );
+			forth_comp.InsertWord_2_Dict( "TYPE",	MakeWord< StackOp< TForth, void, Char *, CellType > >( forth_comp, [ & forth_comp ] ( const auto addr, const auto len ) { for( auto i{0}; i < len; ++ i ) forth_comp.GetOutStream() << addr[ i ]; } ), " addr len -- " );
 
 
 
-			// Comparisons
-			forth_comp.InsertWord_2_Dict( "=",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template EQ< SignedIntType >();  } > >( forth_comp ), " x y -- x<y " );
-			forth_comp.InsertWord_2_Dict( "<>",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template NE< SignedIntType >();  } > >( forth_comp ), " x y -- x<=y " );
-			forth_comp.InsertWord_2_Dict( "<",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template LT< SignedIntType >();  } > >( forth_comp ), " x y -- x>y " );
-			forth_comp.InsertWord_2_Dict( "<=",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template LE< SignedIntType >();  } > >( forth_comp ), " x y -- x>=y " );
-			forth_comp.InsertWord_2_Dict( ">",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template GT< SignedIntType >();  } > >( forth_comp ), " x y -- x=y " );
-			forth_comp.InsertWord_2_Dict( ">=",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template GE< SignedIntType >();  } > >( forth_comp ), " x y -- x<>y " );
+			// Wordlists (VOCABULARY is processed by the interpreter)
+			forth_comp.InsertWord_2_Dict( "WORDLIST",		MakeWord< StackOp< TForth, CellType > >( forth_comp, [ & forth_comp ] () { return forth_comp.NewWordList(); } ), " -- wid " );
+			forth_comp.InsertWord_2_Dict( "GET-CURRENT",	MakeWord< StackOp< TForth, CellType > >( forth_comp, [ & forth_comp ] () { return forth_comp.GetCurrent(); } ), " -- wid " );
+			forth_comp.InsertWord_2_Dict( "SET-CURRENT",	MakeWord< StackOp< TForth, void, CellType > >( forth_comp, [ & forth_comp ] ( CellType wid ) { forth_comp.SetCurrent( wid ); } ), " wid -- " );
 
 
+			// The words of the search order go to the ROOT wordlist, which is searched after all the others - 
+			// so whatever the search order is, it can be changed back (as with the minimum search order of the standard)
+			const auto prev_current { forth_comp.GetCurrent() };
+			forth_comp.SetCurrent( TForth::kRootWordList );
 
+			// Spec words
+			// List all words already in the dictionary
+			forth_comp.InsertWord_2_Dict( "WORDS",	MakeWord< StackOp< TForth, void > >( forth_comp, 
+				[ & forth_comp ] () 
+			{ 
+				std::vector< std::tuple< Name, Name, Name > >		name_comm_vec;
+				auto list_words = [ & ] ( const auto wid )
+				{
+					for( const auto & [ n, w ] : forth_comp.GetWordList( wid ) )
+						if( auto visible = forth_comp.GetWordEntry( n ); visible && * visible == & w )		// skip the shadowed ones
+							name_comm_vec.push_back( std::make_tuple( n, forth_comp.GetWordComment( w ), w.fWordIsImmediate ? " [immediate]" : "" ) );
+				};
+
+				const auto & order { forth_comp.GetSearchOrder() };
+				for( auto i { order.size() }; i -- > 0; )
+				{
+					const auto wid { order.data()[ i ] };
+					if( std::find( order.data() + i + 1, order.data() + order.size(), wid ) != order.data() + order.size() )
+						continue;		// this wordlist has been already listed
+
+					list_words( wid );
+				}
+				list_words( TForth::kRootWordList );
+				std::sort( name_comm_vec.begin(), name_comm_vec.end() );
+				std::for_each( name_comm_vec.begin(), name_comm_vec.end(), [ & forth_comp ] ( const auto & t ) { forth_comp.GetOutStream() << std::get<0>( t ) << "\t\t\t" << std::get<1>( t ) << "\t\t\t\t\t" << std::get<2>( t ) << std::endl; } );
+			} ), " -- " );
 
 
-			forth_comp.InsertWord_2_Dict( "CELLS",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Cells();  }						 > >( forth_comp ), " n -- 8*n " );
-			forth_comp.InsertWord_2_Dict( "CELL+",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.CellPlus();  }						 > >( forth_comp ), " addr -- addr+8" );
-			
-			forth_comp.InsertWord_2_Dict( "@",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template ReadAt< CellType >();  }	 > >( forth_comp ), " addr -- [addr] " );
-			forth_comp.InsertWord_2_Dict( "!",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template WriteAt< CellType >();  }	 > >( forth_comp ), " x addr -- " );
+			// The search order
+			forth_comp.InsertWord_2_Dict( "FORTH-WORDLIST",	MakeWord< StackOp< TForth, CellType > >( forth_comp, [] () { return TForth::kForthWordList; } ), " -- wid " );
+			forth_comp.InsertWord_2_Dict( "DEFINITIONS",	MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () { forth_comp.SetCurrent( forth_comp.GetSearchOrderTop() ); } ), " -- ==> the top wordlist becomes current " );
+			forth_comp.InsertWord_2_Dict( "ALSO",			MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () { forth_comp.Also(); } ), " -- ==> duplicate the top wordlist " );
+			forth_comp.InsertWord_2_Dict( "PREVIOUS",		MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () { forth_comp.Previous(); } ), " -- ==> remove the top wordlist " );
+			forth_comp.InsertWord_2_Dict( "ONLY",			MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () { forth_comp.Only(); } ), " -- ==> only FORTH in the search order " );
+			forth_comp.InsertWord_2_Dict( "FORTH",			MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () { forth_comp.SetSearchOrderTop( TForth::kForthWordList ); } ), " -- " );
 
-			forth_comp.InsertWord_2_Dict( "C@",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template ReadAt< Char >();  }	 > >( forth_comp ), " c_addr -- [c_addr] " );
-			forth_comp.InsertWord_2_Dict( "C!",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template WriteAt< Char >();  }	 > >( forth_comp ), " c c_addr -- " );
-			forth_comp.InsertWord_2_Dict( "C+!",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template UpdateAt< Char >();  } > >( forth_comp ), " c c_addr -- " );
+			forth_comp.InsertWord_2_Dict( "ORDER",	MakeWord< StackOp< TForth, void > >( forth_comp, 
+				[ & forth_comp ] () 
+			{ 
+				const auto WordListName = [ & forth_comp ] ( const auto wid ) { const auto & n { forth_comp.GetWordListName( wid ) }; return n.empty() ? "#" + std::to_string( wid ) : n; };
 
+				const auto & order { forth_comp.GetSearchOrder() };
+				for( auto i { order.size() }; i -- > 0; )
+					forth_comp.GetOutStream() << WordListName( order.data()[ i ] ) << " ";
+				forth_comp.GetOutStream() << WordListName( TForth::kRootWordList ) << "\tcurrent: " << WordListName( forth_comp.GetCurrent() ) << std::endl;
+			} ), " -- ==> print the search order " );
 
+			forth_comp.SetCurrent( prev_current );
 
-			forth_comp.InsertWord_2_Dict( "1+",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template OnePlus< SignedIntType >();  } > >( forth_comp ), " x -- x+1 " );
-			forth_comp.InsertWord_2_Dict( "1-",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template OneMinus< SignedIntType >();  } > >( forth_comp ), " x -- x-1 " );
-			
-			forth_comp.InsertWord_2_Dict( "2+",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template TwoPlus< SignedIntType >();  } > >( forth_comp ), " x -- x+2 " );
-			forth_comp.InsertWord_2_Dict( "2-",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template TwoMinus< SignedIntType >();  } > >( forth_comp ), " x -- x-2 " );
-			forth_comp.InsertWord_2_Dict( "2*",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template TwoTimes< SignedIntType >();  } > >( forth_comp ), " x -- x*2 " );
-			
-			forth_comp.InsertWord_2_Dict( "0=",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template EQ_0< SignedIntType >();  } > >( forth_comp ), " x -- x=0 " );
-			forth_comp.InsertWord_2_Dict( "0<>",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template NE_0< SignedIntType >();  } > >( forth_comp ), " x -- x<>0 " );
-			forth_comp.InsertWord_2_Dict( "0<",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template LT_0< SignedIntType >();  } > >( forth_comp ), " x -- x<0 " );
-			forth_comp.InsertWord_2_Dict( "0<=",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template LE_0< SignedIntType >();  } > >( forth_comp ), " x -- x<=0 " );
-			forth_comp.InsertWord_2_Dict( "0>",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template GT_0< SignedIntType >();  } > >( forth_comp ), " x -- x>0 " );
-			forth_comp.InsertWord_2_Dict( "0>=",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template GE_0< SignedIntType >();  } > >( forth_comp ), " x -- x>=0 " );
 
+			forth_comp.InsertWord_2_Dict( "ARENA-STATS",	MakeWord< StackOp< TForth, void > >( forth_comp, 
+				[ & forth_comp ] () 
+			{ 
+				const auto & arena { forth_comp.GetNodeArena() };
+				forth_comp.GetOutStream()	<< "node arena: " << arena.GetNumOfAllocs() << " allocs, " << arena.GetUsedBytes() << " bytes used of " 
+											<< arena.GetReservedBytes() << " reserved in " << arena.GetNumOfChunks() << " chunks" << std::endl;
+			} ), " -- ==> print the node arena usage " );
 
 
+			forth_comp.InsertWord_2_Dict( "DICT-STATS",	MakeWord< StackOp< TForth, void > >( forth_comp, 
+				[ & forth_comp ] () 
+			{ 
+				const auto stats { TDictReclaimerFor< TForthCompiler >( forth_comp ).GetStats() };
+				const auto & arena { forth_comp.GetNodeArena() };
+				forth_comp.GetOutStream()	<< "dictionary: " << forth_comp.GetDefLog().size() << " defs, " << stats.fNumLiveNodes << " live nodes, " 
+											<< stats.fNumGarbageWords << " garbage words with " << stats.fNumGarbageNodes << " nodes, " 
+											<< forth_comp.GetNumOfReclaimedNodes() << " nodes reclaimed" << std::endl
+											<< "node arena: " << arena.GetUsedBytes() << " bytes used, " << arena.GetFreeBytes() << " bytes free to reuse" << std::endl;
+			} ), " -- ==> print the live and garbage words of the dictionary " );
+
+			forth_comp.InsertWord_2_Dict( "DICT-MEMORY",	MakeWord< StackOp< TForth, void > >( forth_comp, 
+				[ & forth_comp ] () 
+			{ 
+				const auto num_defs { std::max< size_type >( forth_comp.GetDefLog().size(), 1 ) };
+				const auto [ hot, cold ] { forth_comp.GetDictBytes() };
+				forth_comp.GetOutStream()	<< "dictionary memory: " << forth_comp.GetDefLog().size() << " defs, " 
+											<< hot << " bytes hot (" << hot / num_defs << " per def), " << cold << " bytes cold (" << cold / num_defs << " per def)" << std::endl
+											<< "sizeof( WordEntry ) " << sizeof( TForth::WordEntry ) << std::endl;
+			} ), " -- ==> print the bytes taken by the words of the dictionary (without their nodes) " );
 
+			forth_comp.InsertWord_2_Dict( "RECLAIM",	MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () { forth_comp.RequestReclaim(); } ), " -- ==> reclaim the garbage words at the end of the line " );
 
-			// Spec words
-			// List all words already in the dictionary
-			forth_comp.InsertWord_2_Dict( "WORDS",	std::make_unique< StackOp< TForth, void > >( forth_comp, 
+
+			forth_comp.InsertWord_2_Dict( "PRIMITIVES",	MakeWord< StackOp< TForth, void > >( forth_comp, 
 				[ & forth_comp ] () 
 			{ 
-				std::vector< std::tuple< Name, Name, Name > >		name_comm_vec;
-				for( const auto & [ n, w ] : forth_comp.GetWordDict() )
-					name_comm_vec.push_back( std::make_tuple( n, w.fWordComment, w.fWordIsImmediate ? " [immediate]" : "" ) );
-				std::sort( name_comm_vec.begin(), name_comm_vec.end() );
-				std::for_each( name_comm_vec.begin(), name_comm_vec.end(), [ & forth_comp ] ( const auto & t ) { forth_comp.GetOutStream() << std::get<0>( t ) << "\t\t\t" << std::get<1>( t ) << "\t\t\t\t\t" << std::get<2>( t ) << std::endl; } );
-			} ), " -- " );
+				for( const auto & p : kPrimitives )
+					forth_comp.GetOutStream()	<< p.fName << "\t\t" << + p.fNumIn << " -> " << + p.fNumOut << ( p.fPure ? "\tpure" : "\t" ) << "\t\t(" << p.fComment << ")" << std::endl;
+			} ), " -- ==> print the primitives with their stack effects " );
 
 
-			forth_comp.InsertWord_2_Dict( "ABORT",	std::make_unique< Abort< TForth > >( forth_comp, "ABORT called" ), " -- " );
+			forth_comp.InsertWord_2_Dict( "ABORT",	MakeWord< Abort< TForth > >( forth_comp, "ABORT called" ), " -- " );
 
 
-			forth_comp.InsertWord_2_Dict( "LEAVE",	std::make_unique< LEAVE< TForth > >( forth_comp ), " -- " );
+			forth_comp.InsertWord_2_Dict( "LEAVE",	MakeWord< LEAVE< TForth > >( forth_comp ), " -- " );
 
 		}
 
@@ -191,9 +226,6 @@ namespace BCForth
 					": -ROT ( x y z -- z x y ) ROT ROT ;",
 
 
-					": */ ( x y z -- (x*y)/z ) ROT ROT * SWAP / ;",
-
-
 					": ? ( addr -- ) @ . ;",	// a word to query a variable
 
 					": CHARS ( -- ) ;",			// just no-op
@@ -264,6 +296,26 @@ namespace BCForth
 
 
 
+					// The floats take one cell, whichever stack they are on
+					// e.g.
+					// 3.14 FCONSTANT PI
+					// FVARIABLE RADIUS  2.0 RADIUS F!  RADIUS F@ PI F* .F
+					R"(	: FVARIABLE			( -- | ) 
+									CREATE 1 CELLS ALLOT	\\ at compile create one cell for a float	\n
+									DOES>	( -- addr )		\\ at run-time return its address \n
+						; 
+					)",
+
+					R"(	: FCONSTANT			( F: r -- | ) 
+									CREATE					\\ at compile time, create new data \n
+										F,					\\ write in the float r \n
+									DOES>	( F: -- r )		\\ get address of data & push the float onto the floating-point stack \n
+									F@
+						; 
+					)",
+
+
+
 
 					// e.g.
 					// 100 BUFFER:	DATA	/ create a buffer DATA of 100 bytes
@@ -310,11 +362,6 @@ namespace BCForth
 
 
 
-					// These must go AFTER the creational words CONSTANT and VARIABLE
-
-					"VARIABLE BASE",		// define
-
-
 					": HEX 16 BASE ! ;",			
 					": DEC 10 BASE ! ;",		
 
@@ -13,6 +13,7 @@
 
 
 #include "Words.h"
+#include "FloatStackWords.h"
 #include "ForthCompiler.h"
 #include <cmath>
 #include <random>
@@ -23,58 +24,167 @@ namespace BCForth
 {
 
 
+	// The floating-point words. If the Forth has the floating-point stack, then they use it (as in the Forth standard) 
+	// - otherwise the floats are kept in the cells of the data stack, and FDUP etc. are the same as DUP etc.
 	class FP_Module : public TForthModule
 	{
 
+	public:
 
+		// The names of the words of this module (these can be entered before the words are made)
+		static inline const Names kManifest {	".F", ".FS", ".SDF", "F+", "F-", "F*", "F/", "F=", "F<>", "F<", "F<=", "F>", "F>=", 
+												"FNEG", "SQRT", "POW", "SIN", "COS", "TAN", "ATAN", "ATAN2", "2INT", "2FP",
+												"FDUP", "FSWAP", "FOVER", "FROT", "FDROP", "F@", "F!", "F," };
 
 	public:
 
 		// Call to upload new words to the forth_comp
 		void operator () ( TForthCompiler & forth_comp ) override
 		{
+			if( forth_comp.HasFloatStack() )
+			{
+				InsertFloatStackWords( forth_comp );
+				return;
+			}
 
 
-			forth_comp.InsertWord_2_Dict( ".F",		std::make_unique< Dot< TForth, FloatType > >( forth_comp, forth_comp.GetOutStream() ), " xf -- " );
-			forth_comp.InsertWord_2_Dict( ".FS",	std::make_unique< Dot_S< TForth, FloatType > >( forth_comp, forth_comp.GetOutStream() ), " xf -- xf " );
-			forth_comp.InsertWord_2_Dict( ".SDF",	std::make_unique< Stack_Dump< TForth, FloatType > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kSpace ) ), " x -- x ==> float stack dump " );
+			forth_comp.InsertWord_2_Dict( ".F",		MakeWord< Dot< TForth, FloatType > >( forth_comp, forth_comp.GetOutStream() ), " xf -- " );
+			forth_comp.InsertWord_2_Dict( ".FS",	MakeWord< Dot_S< TForth, FloatType > >( forth_comp, forth_comp.GetOutStream() ), " xf -- xf " );
+			forth_comp.InsertWord_2_Dict( ".SDF",	MakeWord< Stack_Dump< TForth, FloatType > >( forth_comp, forth_comp.GetOutStream(), Letter_2_Name( kSpace ) ), " x -- x ==> float stack dump " );
 
 
-			forth_comp.InsertWord_2_Dict( "F+",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Plus< FloatType >(); }	> >( forth_comp ), " xf yf -- xf+yf " );
-			forth_comp.InsertWord_2_Dict( "F-",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Minus< FloatType >(); }	> >( forth_comp ), " xf yf -- xf-yf " );
-			forth_comp.InsertWord_2_Dict( "F*",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Mult< FloatType >(); }	> >( forth_comp ), " xf yf -- xf*yf " );
-			forth_comp.InsertWord_2_Dict( "F/",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Div< FloatType >(); }		> >( forth_comp ), " xf yf -- xf/yf " );
+			forth_comp.InsertWord_2_Dict( "F+",		MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Plus< FloatType >(); }	> >( forth_comp ), " xf yf -- xf+yf " );
+			forth_comp.InsertWord_2_Dict( "F-",		MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Minus< FloatType >(); }	> >( forth_comp ), " xf yf -- xf-yf " );
+			forth_comp.InsertWord_2_Dict( "F*",		MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Mult< FloatType >(); }	> >( forth_comp ), " xf yf -- xf*yf " );
+			forth_comp.InsertWord_2_Dict( "F/",		MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template Div< FloatType >(); }		> >( forth_comp ), " xf yf -- xf/yf " );
 
 
-			forth_comp.InsertWord_2_Dict( "F=",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template EQ< FloatType >();  } > >( forth_comp ), " xf yf -- xf<yf " );
-			forth_comp.InsertWord_2_Dict( "F<>",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template NE< FloatType >();  } > >( forth_comp ), " xf yf -- xf<=yf " );
-			forth_comp.InsertWord_2_Dict( "F<",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template LT< FloatType >();  } > >( forth_comp ), " xf yf -- xf>yf " );
-			forth_comp.InsertWord_2_Dict( "F<=",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template LE< FloatType >();  } > >( forth_comp ), " xf yf -- xf>=yf " );
-			forth_comp.InsertWord_2_Dict( "F>",		std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template GT< FloatType >();  } > >( forth_comp ), " xf yf -- xf=yf " );
-			forth_comp.InsertWord_2_Dict( "F>=",	std::make_unique< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template GE< FloatType >();  } > >( forth_comp ), " xf yf -- xf<>yf " );
+			forth_comp.InsertWord_2_Dict( "F=",		MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template EQ< FloatType >();  } > >( forth_comp ), " xf yf -- xf<yf " );
+			forth_comp.InsertWord_2_Dict( "F<>",	MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template NE< FloatType >();  } > >( forth_comp ), " xf yf -- xf<=yf " );
+			forth_comp.InsertWord_2_Dict( "F<",		MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template LT< FloatType >();  } > >( forth_comp ), " xf yf -- xf>yf " );
+			forth_comp.InsertWord_2_Dict( "F<=",	MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template LE< FloatType >();  } > >( forth_comp ), " xf yf -- xf>=yf " );
+			forth_comp.InsertWord_2_Dict( "F>",		MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template GT< FloatType >();  } > >( forth_comp ), " xf yf -- xf=yf " );
+			forth_comp.InsertWord_2_Dict( "F>=",	MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template GE< FloatType >();  } > >( forth_comp ), " xf yf -- xf<>yf " );
 
 
 			using UnaryFloatOp = StackOp< TForth, FloatType, FloatType >;
 			using BinFloatOp = StackOp< TForth, FloatType, FloatType, FloatType >;
 
-			forth_comp.InsertWord_2_Dict( "FNEG",	std::make_unique< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return -x; } ), " x -- -x " );
+			forth_comp.InsertWord_2_Dict( "FNEG",	MakeWord< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return -x; } ), " x -- -x " );
 
 
-			forth_comp.InsertWord_2_Dict( "SQRT",	std::make_unique< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::sqrt( x ); } ), " xf -- sqrt(xf) " );
-			forth_comp.InsertWord_2_Dict( "POW",	std::make_unique< BinFloatOp >( forth_comp, [] ( const auto x, const auto y ) { return std::pow( x, y ); } ), " xf yf -- pow(xf,yf) " );
+			forth_comp.InsertWord_2_Dict( "SQRT",	MakeWord< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::sqrt( x ); } ), " xf -- sqrt(xf) " );
+			forth_comp.InsertWord_2_Dict( "POW",	MakeWord< BinFloatOp >( forth_comp, [] ( const auto x, const auto y ) { return std::pow( x, y ); } ), " xf yf -- pow(xf,yf) " );
 
 
-			forth_comp.InsertWord_2_Dict( "SIN",	std::make_unique< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::sin( x ); } ), " xf -- sin(xf) " );
-			forth_comp.InsertWord_2_Dict( "COS",	std::make_unique< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::cos( x ); } ), " xf -- cos(xf) " );
-			forth_comp.InsertWord_2_Dict( "TAN",	std::make_unique< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::tan( x ); } ), " xf -- tan(xf) " );
-			forth_comp.InsertWord_2_Dict( "ATAN",	std::make_unique< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::tan( x ); } ), " xf -- atan(xf) " );
-			forth_comp.InsertWord_2_Dict( "ATAN2",	std::make_unique< BinFloatOp >( forth_comp, [] ( const auto x, const auto y ) { return std::atan2( x, y ); } ), " xf yf -- atan2(xf,yf) " );
+			forth_comp.InsertWord_2_Dict( "SIN",	MakeWord< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::sin( x ); } ), " xf -- sin(xf) " );
+			forth_comp.InsertWord_2_Dict( "COS",	MakeWord< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::cos( x ); } ), " xf -- cos(xf) " );
+			forth_comp.InsertWord_2_Dict( "TAN",	MakeWord< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::tan( x ); } ), " xf -- tan(xf) " );
+			forth_comp.InsertWord_2_Dict( "ATAN",	MakeWord< UnaryFloatOp >( forth_comp, [] ( const auto x ) { return std::atan( x ); } ), " xf -- atan(xf) " );
+			forth_comp.InsertWord_2_Dict( "ATAN2",	MakeWord< BinFloatOp >( forth_comp, [] ( const auto x, const auto y ) { return std::atan2( x, y ); } ), " xf yf -- atan2(xf,yf) " );
 
 
 			// Convert the top data int->float, float->int
-			forth_comp.InsertWord_2_Dict( "2INT",	std::make_unique< StackOp< TForth, SignedIntType, FloatType > >( forth_comp, [] ( const auto x ) { return static_cast< SignedIntType >( x ); } ), " f -- i " );
-			forth_comp.InsertWord_2_Dict( "2FP",	std::make_unique< StackOp< TForth, FloatType, SignedIntType > >( forth_comp, [] ( const auto x ) { return static_cast< FloatType >( x ); } ), " i -- f " );
+			forth_comp.InsertWord_2_Dict( "2INT",	MakeWord< StackOp< TForth, SignedIntType, FloatType > >( forth_comp, [] ( const auto x ) { return static_cast< SignedIntType >( x ); } ), " f -- i " );
+			forth_comp.InsertWord_2_Dict( "2FP",	MakeWord< StackOp< TForth, FloatType, SignedIntType > >( forth_comp, [] ( const auto x ) { return static_cast< FloatType >( x ); } ), " i -- f " );
+
 
+			// A float is a cell here
+			forth_comp.InsertWord_2_Dict( "FDUP",	MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Dup(); } > >( forth_comp ), " xf -- xf xf " );
+			forth_comp.InsertWord_2_Dict( "FSWAP",	MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Swap(); } > >( forth_comp ), " xf yf -- yf xf " );
+			forth_comp.InsertWord_2_Dict( "FOVER",	MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Over(); } > >( forth_comp ), " xf yf -- xf yf xf " );
+			forth_comp.InsertWord_2_Dict( "FROT",	MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Rot(); } > >( forth_comp ), " xf yf zf -- yf zf xf " );
+			forth_comp.InsertWord_2_Dict( "FDROP",	MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.Drop(); } > >( forth_comp ), " xf -- " );
+
+			forth_comp.InsertWord_2_Dict( "F@",		MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template ReadAt< FloatType >(); } > >( forth_comp ), " addr -- xf " );
+			forth_comp.InsertWord_2_Dict( "F!",		MakeWord< ExGenericStackOp< TForth, [] ( auto & ds ) { return ds.template WriteAt< FloatType >(); } > >( forth_comp ), " xf addr -- " );
+			forth_comp.InsertWord_2_Dict( "F,",		MakeWord< Comma< TForth, CellType > >( forth_comp ), " xf -- " );
+		}
+
+	private:
+
+		// The same words on the floating-point stack - the flags, the integers and the addresses stay on the data stack
+		static void InsertFloatStackWords( TForthCompiler & forth_comp )
+		{
+			using FS = TForth::FloatStack;
+
+			forth_comp.InsertWord_2_Dict( ".F",		MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () 
+			{ 
+				if( FloatType x {}; forth_comp.GetFloatStack().Pop( x ) )
+					forth_comp.GetOutStream() << x;
+				else
+					throw ForthError( "unexpectedly empty floating-point stack" );
+			} ), " F: xf -- " );
+			forth_comp.InsertWord_2_Dict( ".FS",	MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () 
+			{ 
+				if( FloatType x {}; forth_comp.GetFloatStack().Peek( x ) )
+					forth_comp.GetOutStream() << x;
+				else
+					throw ForthError( "unexpectedly empty floating-point stack" );
+			} ), " F: xf -- xf " );
+			forth_comp.InsertWord_2_Dict( ".SDF",	MakeWord< StackOp< TForth, void > >( forth_comp, [ & forth_comp ] () 
+			{ 
+				const auto & fs { forth_comp.GetFloatStack() };
+				std::for_each( fs.data(), fs.data() + fs.size(), [ & forth_comp ] ( const auto x ) { forth_comp.GetOutStream() << x << kSpace; } );
+				forth_comp.GetOutStream() << kCR;
+			} ), " F: xf -- xf ==> float stack dump " );
+
+
+			forth_comp.InsertWord_2_Dict( "F+",		MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { return fs.template Plus< FloatType >(); }	> >( forth_comp ), " F: xf yf -- xf+yf " );
+			forth_comp.InsertWord_2_Dict( "F-",		MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { return fs.template Minus< FloatType >(); }	> >( forth_comp ), " F: xf yf -- xf-yf " );
+			forth_comp.InsertWord_2_Dict( "F*",		MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { return fs.template Mult< FloatType >(); }	> >( forth_comp ), " F: xf yf -- xf*yf " );
+			forth_comp.InsertWord_2_Dict( "F/",		MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { return fs.template Div< FloatType >(); }	> >( forth_comp ), " F: xf yf -- xf/yf " );
+
+
+			// The flags go to the data stack
+			forth_comp.InsertWord_2_Dict( "F=",		MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) { FloatType x {}, y {}; return fs.Pop( y ) && fs.Pop( x ) && ds.Push( x == y ? kBoolTrue : kBoolFalse ); } > >( forth_comp ), " F: xf yf -- ==> xf=yf " );
+			forth_comp.InsertWord_2_Dict( "F<>",	MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) { FloatType x {}, y {}; return fs.Pop( y ) && fs.Pop( x ) && ds.Push( x != y ? kBoolTrue : kBoolFalse ); } > >( forth_comp ), " F: xf yf -- ==> xf<>yf " );
+			forth_comp.InsertWord_2_Dict( "F<",		MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) { FloatType x {}, y {}; return fs.Pop( y ) && fs.Pop( x ) && ds.Push( x < y ? kBoolTrue : kBoolFalse ); } > >( forth_comp ), " F: xf yf -- ==> xf<yf " );
+			forth_comp.InsertWord_2_Dict( "F<=",	MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) { FloatType x {}, y {}; return fs.Pop( y ) && fs.Pop( x ) && ds.Push( x <= y ? kBoolTrue : kBoolFalse ); } > >( forth_comp ), " F: xf yf -- ==> xf<=yf " );
+			forth_comp.InsertWord_2_Dict( "F>",		MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) { FloatType x {}, y {}; return fs.Pop( y ) && fs.Pop( x ) && ds.Push( x > y ? kBoolTrue : kBoolFalse ); } > >( forth_comp ), " F: xf yf -- ==> xf>yf " );
+			forth_comp.InsertWord_2_Dict( "F>=",	MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) { FloatType x {}, y {}; return fs.Pop( y ) && fs.Pop( x ) && ds.Push( x >= y ? kBoolTrue : kBoolFalse ); } > >( forth_comp ), " F: xf yf -- ==> xf>=yf " );
+
+
+			forth_comp.InsertWord_2_Dict( "FNEG",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { FloatType x {}; return fs.Pop( x ) && fs.Push( -x ); } > >( forth_comp ), " F: x -- -x " );
+
+
+			forth_comp.InsertWord_2_Dict( "SQRT",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { FloatType x {}; return fs.Pop( x ) && fs.Push( std::sqrt( x ) ); } > >( forth_comp ), " F: xf -- sqrt(xf) " );
+			forth_comp.InsertWord_2_Dict( "POW",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { FloatType x {}, y {}; return fs.Pop( y ) && fs.Pop( x ) && fs.Push( std::pow( x, y ) ); } > >( forth_comp ), " F: xf yf -- pow(xf,yf) " );
+
+
+			forth_comp.InsertWord_2_Dict( "SIN",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { FloatType x {}; return fs.Pop( x ) && fs.Push( std::sin( x ) ); } > >( forth_comp ), " F: xf -- sin(xf) " );
+			forth_comp.InsertWord_2_Dict( "COS",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { FloatType x {}; return fs.Pop( x ) && fs.Push( std::cos( x ) ); } > >( forth_comp ), " F: xf -- cos(xf) " );
+			forth_comp.InsertWord_2_Dict( "TAN",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { FloatType x {}; return fs.Pop( x ) && fs.Push( std::tan( x ) ); } > >( forth_comp ), " F: xf -- tan(xf) " );
+			forth_comp.InsertWord_2_Dict( "ATAN",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { FloatType x {}; return fs.Pop( x ) && fs.Push( std::atan( x ) ); } > >( forth_comp ), " F: xf -- atan(xf) " );
+			forth_comp.InsertWord_2_Dict( "ATAN2",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { FloatType x {}, y {}; return fs.Pop( y ) && fs.Pop( x ) && fs.Push( std::atan2( x, y ) ); } > >( forth_comp ), " F: xf yf -- atan2(xf,yf) " );
+
+
+			// Convert int <-> float, between the stacks
+			forth_comp.InsertWord_2_Dict( "2INT",	MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) { FloatType x {}; return fs.Pop( x ) && ds.Push( static_cast< CellType >( static_cast< SignedIntType >( x ) ) ); } > >( forth_comp ), " F: f -- ==> -- i " );
+			forth_comp.InsertWord_2_Dict( "2FP",	MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) { CellType x {}; return ds.Pop( x ) && fs.Push( static_cast< FloatType >( static_cast< SignedIntType >( x ) ) ); } > >( forth_comp ), " i -- ==> F: -- f " );
+
+
+			// The stack words come from the mixins, as those of the data stack
+			forth_comp.InsertWord_2_Dict( "FDUP",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { return fs.Dup(); } > >( forth_comp ), " F: xf -- xf xf " );
+			forth_comp.InsertWord_2_Dict( "FSWAP",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { return fs.Swap(); } > >( forth_comp ), " F: xf yf -- yf xf " );
+			forth_comp.InsertWord_2_Dict( "FOVER",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { return fs.Over(); } > >( forth_comp ), " F: xf yf -- xf yf xf " );
+			forth_comp.InsertWord_2_Dict( "FROT",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { return fs.Rot(); } > >( forth_comp ), " F: xf yf zf -- yf zf xf " );
+			forth_comp.InsertWord_2_Dict( "FDROP",	MakeWord< ExFloatStackOp< TForth, [] ( auto &, FS & fs ) { return fs.Drop(); } > >( forth_comp ), " F: xf -- " );
+
+
+			// The addresses are on the data stack
+			forth_comp.InsertWord_2_Dict( "F@",		MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) 
+			{ 
+				CellType addr {}; 
+				return ds.Pop( addr ) && fs.Push( * reinterpret_cast< const FloatType * >( addr ) ); 
+			} > >( forth_comp ), " addr -- ==> F: -- xf " );
+			forth_comp.InsertWord_2_Dict( "F!",		MakeWord< ExFloatStackOp< TForth, [] ( auto & ds, FS & fs ) 
+			{ 
+				CellType addr {}; 
+				FloatType x {};
+				return ds.Pop( addr ) && fs.Pop( x ) && ( * reinterpret_cast< FloatType * >( addr ) = x, true ); 
+			} > >( forth_comp ), " addr -- ==> F: xf -- " );
+			forth_comp.InsertWord_2_Dict( "F,",		MakeWord< FloatComma< TForth > >( forth_comp ), " F: xf -- " );
 		}
 
 	};
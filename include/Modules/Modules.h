@@ -15,6 +15,9 @@
 #include "ForthCompiler.h"
 #include "Tokenizer.h"
 #include <filesystem>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 
 
@@ -71,7 +74,9 @@ namespace BCForth
 			for( const auto & word : fWords )
 			{ 
 				std::istringstream ss( word );
-				forth_comp( TForthReader()( ss ) );	
+				for( TForthReader reader; ss; forth_comp( reader( ss ) ) )		// a definition can span many lines
+					;
+				forth_comp.CheckEndOfSource( "the text " + word.substr( 0, word.find( kCR ) ) );
 			}
 		}
 
@@ -128,8 +133,226 @@ namespace BCForth
 		void operator () ( TForthCompiler & forth_comp ) override
 		{
 			if( std::ifstream fs( fFModulePath ); fs )
+			{
 				for( TForthReader fileReader; fs; forth_comp( fileReader( fs ) ) ) 
 					;	
+				forth_comp.CheckEndOfSource( fFModulePath.string() );
+			}
+		}
+
+	};
+
+
+	// ----------------------------------------
+	// Reads and uploads the words of a number of files, in the given order (each can use the words of the ones
+	// before it). The files are tokenized on fNumJobs threads, some files ahead of the compiler, which takes
+	// their lines one after another - so only the compilation is serial.
+	class SourceFilesModule : public TForthModule
+	{
+
+		const std::vector< fs::path >	fPaths;
+
+		const unsigned		fNumJobs;
+
+		// The tokens of a file, line after line (as given by TForthReader)
+		struct TokenizedFile
+		{
+			std::vector< Names >	fLines;
+			bool					fOpened { false };
+			bool					fReady { false };
+		};
+
+	public:
+
+		SourceFilesModule( std::vector< fs::path > paths, unsigned num_jobs ) : fPaths( std::move( paths ) ), fNumJobs( std::max( num_jobs, 1u ) ) {}
+
+
+	public:
+
+		void operator () ( TForthCompiler & forth_comp ) override
+		{
+			if( fNumJobs == 1 || fPaths.size() <= 1 )
+			{
+				for( const auto & path : fPaths )
+				{
+					std::ifstream fs( path );
+					if( ! fs )
+						throw ForthError( "cannot open the file " + path.string() );
+
+					for( TForthReader fileReader; fs; forth_comp( fileReader( fs ) ) )
+						;
+					forth_comp.CheckEndOfSource( path.string() );
+				}
+				return;
+			}
+
+			std::vector< TokenizedFile >	files( fPaths.size() );
+
+			std::mutex					mtx;
+			std::condition_variable		cv;
+			size_type	next {};			// the first file not taken by the workers
+			size_type	consumed {};		// the files already compiled
+			bool		stop { false };
+
+			// The workers keep at most 2 * fNumJobs tokenized files ahead of the compiler
+			auto worker = [ & ]
+			{
+				for( ;; )
+				{
+					size_type k {};
+					{
+						std::unique_lock lock( mtx );
+						cv.wait( lock, [ & ] { return stop || next == files.size() || next < consumed + 2 * fNumJobs; } );
+						if( stop || next == files.size() )
+							return;
+						k = next ++;
+					}
+
+					TokenizedFile file;
+					if( std::ifstream fs( fPaths[ k ] ); fs )
+					{
+						file.fOpened = true;
+						for( TForthReader fileReader; fs; )
+							if( auto ns { fileReader( fs ) }; ! ns.empty() )
+								file.fLines.emplace_back( std::move( ns ) );
+					}
+
+					{
+						std::lock_guard lock( mtx );
+						files[ k ] = std::move( file );
+						files[ k ].fReady = true;
+					}
+					cv.notify_all();
+				}
+			};
+
+			std::vector< std::thread > pool;
+			for( unsigned i {}; i < std::min< size_type >( fNumJobs, files.size() ); ++ i )
+				pool.emplace_back( worker );
+
+			auto join_all = [ & ]
+			{
+				{
+					std::lock_guard lock( mtx );
+					stop = true;
+				}
+				cv.notify_all();
+				for( auto & t : pool )
+					t.join();
+			};
+
+			try
+			{
+				for( size_type k {}; k < files.size(); ++ k )
+				{
+					TokenizedFile file;
+					{
+						std::unique_lock lock( mtx );
+						cv.wait( lock, [ & ] { return files[ k ].fReady; } );
+						file = std::move( files[ k ] );
+						consumed = k + 1;
+					}
+					cv.notify_all();
+
+					if( ! file.fOpened )
+						throw ForthError( "cannot open the file " + fPaths[ k ].string() );
+
+					for( auto & ns : file.fLines )
+						forth_comp( std::move( ns ) );
+					forth_comp.CheckEndOfSource( fPaths[ k ].string() );
+				}
+			}
+			catch( ... )
+			{
+				join_all();
+				throw;
+			}
+
+			join_all();
+		}
+
+	};
+
+
+	// ----------------------------------------
+	// Uploads the words of another module to its own, named wordlist.
+	// The wordlist goes to the search order just below the top one, so the words
+	// defined later take precedence and the same names in the modules do not collide.
+	template < typename Module >
+	class WordListModule : public TForthModule
+	{
+
+		const Name		fWordListName;
+
+		Module			fModule;
+
+	public:
+
+		WordListModule( Name name, Module module ) : fWordListName( name ), fModule( std::move( module ) ) {}
+
+
+	public:
+
+		void operator () ( TForthCompiler & forth_comp ) override
+		{
+			const auto prev_current { forth_comp.GetCurrent() };
+
+			const auto wid { forth_comp.InsertVocabulary_2_Dict( fWordListName ) };	// the vocabulary word goes to the current wordlist
+			forth_comp.AddToSearchOrder( wid );
+
+			forth_comp.SetCurrent( wid );
+			fModule( forth_comp );
+			forth_comp.SetCurrent( prev_current );
+		}
+
+	};
+
+
+	// ----------------------------------------
+	// As WordListModule, but at first only the names of the words (Module::kManifest) go to the wordlist - 
+	// the module makes its words when one of them is called for the first time, or with REQUIRE-MODULE.
+	// So a program pays only for the modules it uses.
+	template < typename Module >
+	class LazyWordListModule : public TForthModule
+	{
+
+		const Name		fWordListName;
+
+		Module			fModule;
+
+	public:
+
+		LazyWordListModule( Name name, Module module ) : fWordListName( name ), fModule( std::move( module ) ) {}
+
+
+	public:
+
+		void operator () ( TForthCompiler & forth_comp ) override
+		{
+			const auto prev_current { forth_comp.GetCurrent() };
+
+			const auto wid { forth_comp.InsertVocabulary_2_Dict( fWordListName ) };
+			forth_comp.AddToSearchOrder( wid );
+
+			const auto module { forth_comp.RegisterLazyModule( fWordListName, [ & forth_comp, wid, module = fModule ] () mutable
+																{
+																	const auto prev_current { forth_comp.GetCurrent() };
+																	forth_comp.SetCurrent( wid );
+																	try
+																	{
+																		module( forth_comp );
+																	}
+																	catch( ... )
+																	{
+																		forth_comp.SetCurrent( prev_current );
+																		throw;
+																	}
+																	forth_comp.SetCurrent( prev_current );
+																} ) };
+
+			forth_comp.SetCurrent( wid );
+			forth_comp.InsertLazyWords_2_Dict( module, Module::kManifest );
+			forth_comp.SetCurrent( prev_current );
 		}
 
 	};
@@ -149,7 +372,7 @@ namespace BCForth
 		void operator () ( TForthCompiler & forth_comp ) override
 		{
 
-			forth_comp.InsertWord_2_Dict( "2OVER",	std::make_unique< ExGenericStackOp< TForth,
+			forth_comp.InsertWord_2_Dict( "2OVER",	MakeWord< ExGenericStackOp< TForth,
 
 				[] ( auto & ds )	{	const auto kReqElems { 4 };	// at least 4 data on the stack
 										if( ds.size() < kReqElems ) return false;
@@ -163,7 +386,7 @@ namespace BCForth
 
 
 
-			forth_comp.InsertWord_2_Dict( "2SWAP",	std::make_unique< ExGenericStackOp< TForth,
+			forth_comp.InsertWord_2_Dict( "2SWAP",	MakeWord< ExGenericStackOp< TForth,
 
 				[] ( auto & ds )	{	const auto kReqElems { 4 };	// at least 4 data on the stack
 										if( ds.size() < kReqElems ) return false;
@@ -177,7 +400,7 @@ namespace BCForth
 
 
 
-			forth_comp.InsertWord_2_Dict( "2ROT",	std::make_unique< ExGenericStackOp< TForth,
+			forth_comp.InsertWord_2_Dict( "2ROT",	MakeWord< ExGenericStackOp< TForth,
 
 				[] ( auto & ds )	{	const auto kReqElems { 6 };	// at least 6 data on the stack
 										if( ds.size() < kReqElems ) return false;
@@ -197,7 +420,7 @@ namespace BCForth
 			> >( forth_comp ), " x y p q s t -- p q s t x y " );
 
 			// Call this to remove all data from the data stack
-			forth_comp.InsertWord_2_Dict( "SCLEAR",	std::make_unique< ExGenericStackOp< TForth, 
+			forth_comp.InsertWord_2_Dict( "SCLEAR",	MakeWord< ExGenericStackOp< TForth, 
 																						[] ( auto & ds )	{	ds.clear(); return true; } 
 																	> >( forth_comp ), " a ... z --  " );
 
@@ -207,21 +430,21 @@ namespace BCForth
 
 
 			// top data stack ==> ret stack
-			forth_comp.InsertWord_2_Dict( ">R",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( ">R",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[ & retStack ] ( auto & ds )	{	TForthCompiler::DataStack::value_type x;
 													return ds.Pop( x ) ? retStack.Push( x ) : false;
 												}	), " x -- | R: -- x " );
 
 
 			// top ret stack ==> data stack
-			forth_comp.InsertWord_2_Dict( "R>",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "R>",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[ & retStack ] ( auto & ds )	{	TForthCompiler::DataStack::value_type x;
 													return retStack.Pop( x ) ? ds.Push( x ) : false;
 												}	), " -- x | R: x -- " );
 
 
 			// a copy of the top ret stack ==> data stack
-			forth_comp.InsertWord_2_Dict( "R@",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "R@",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[ & retStack ] ( auto & ds )	{	TForthCompiler::DataStack::value_type x;
 													return retStack.Peek( x ) ? ds.Push( x ) : false;
 												}	), " -- x | R: x -- x " );
@@ -231,14 +454,14 @@ namespace BCForth
 
 
 			// 2 top data stack ==> 2 ret stack
-			forth_comp.InsertWord_2_Dict( "2>R",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "2>R",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[ & retStack ] ( auto & ds )	{	TForthCompiler::DataStack::value_type x, y;
 													return ds.Pop( y ) && ds.Pop( x ) ? retStack.Push( x ) && retStack.Push( y ) : false;
 												}	), " x y -- | R: -- x y " );
 
 
 			// 2 top ret stack ==> 2 data stack
-			forth_comp.InsertWord_2_Dict( "2R>",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "2R>",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[ & retStack ] ( auto & ds )	{	TForthCompiler::DataStack::value_type x, y;
 													return retStack.Pop( y ) && retStack.Pop( x ) ? ds.Push( x ) && ds.Push( y ) : false;
 												}	), " -- x y | R: x y -- " );
@@ -0,0 +1,160 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+#pragma once
+
+
+
+#include "Forth.h"
+#include <array>
+#include <string_view>
+
+
+
+
+namespace BCForth
+{
+
+
+	// The primitives - the words which only operate on the data stack (and on the memory).
+	// All of them are described once in kPrimitives, which is used to enter them to the dictionary
+	// and by anything that needs to know their stack effects (e.g. PRIMITIVES prints them).
+	enum class EPrimitive : unsigned char
+	{
+		kDrop, kDup, kSwap, kOver, kRot,
+		kPlus, kMinus, kMult, kDiv, kMod, kNeg,
+		kAnd, kOr, kXor, kInvert,
+		kEQ, kNE, kLT, kLE, kGT, kGE,
+		kCells, kCellPlus,
+		kFetch, kStore, kCharFetch, kCharStore, kCharPlusStore,
+		kOnePlus, kOneMinus, kTwoPlus, kTwoMinus, kTwoTimes,
+		kEQ_0, kNE_0, kLT_0, kLE_0, kGT_0, kGE_0,
+		kS_2_D, kDNegate, kDPlus, kDMinus, kDLess,
+		kUMStar, kMStar, kUMSlashMod, kSMSlashRem, kStarSlash, kStarSlashMod, kMStarSlash,
+
+		kNumOfPrimitives
+	};
+
+
+	struct TPrimitive
+	{
+		using DS = TForth::DataStack;
+
+		std::string_view	fName;
+		EPrimitive			fOpCode {};
+		unsigned char		fNumIn {};			// the stack effect - the number of the cells taken
+		unsigned char		fNumOut {};			// and left on the data stack
+		bool				fPure {};			// the result depends only on the input cells (no memory access, no I/O)
+		std::string_view	fComment;
+		bool			( * fAction )( DS & ) {};	// returns false if the stack is not sufficient
+	};
+
+
+	using PrimDS = TPrimitive::DS;
+
+	inline constexpr std::array< TPrimitive, static_cast< size_type >( EPrimitive::kNumOfPrimitives ) > kPrimitives
+	{ {
+		{ "DROP",	EPrimitive::kDrop,			1, 0, true,		" x -- ",				[] ( PrimDS & ds ) { return ds.Drop(); } },
+		{ "DUP",	EPrimitive::kDup,			1, 2, true,		" x -- x x ",			[] ( PrimDS & ds ) { return ds.Dup(); } },
+		{ "SWAP",	EPrimitive::kSwap,			2, 2, true,		" x y -- y x ",			[] ( PrimDS & ds ) { return ds.Swap(); } },
+		{ "OVER",	EPrimitive::kOver,			2, 3, true,		" x y -- x y x ",		[] ( PrimDS & ds ) { return ds.Over(); } },
+		{ "ROT",	EPrimitive::kRot,			3, 3, true,		" x y z -- y z x ",		[] ( PrimDS & ds ) { return ds.Rot(); } },
+
+		{ "+",		EPrimitive::kPlus,			2, 1, true,		" x y -- x+y ",			[] ( PrimDS & ds ) { return ds.template Plus< SignedIntType >(); } },
+		{ "-",		EPrimitive::kMinus,			2, 1, true,		" x y -- x-y ",			[] ( PrimDS & ds ) { return ds.template Minus< SignedIntType >(); } },
+		{ "*",		EPrimitive::kMult,			2, 1, true,		" x y -- x*y ",			[] ( PrimDS & ds ) { return ds.template Mult< SignedIntType >(); } },
+		{ "/",		EPrimitive::kDiv,			2, 1, true,		" x y -- x/y ",			[] ( PrimDS & ds ) { return ds.template Div< SignedIntType >(); } },
+		{ "MOD",	EPrimitive::kMod,			2, 1, true,		" x y -- x_MOD_y ",		[] ( PrimDS & ds ) { return ds.template Mod< SignedIntType >(); } },
+		{ "NEG",	EPrimitive::kNeg,			1, 1, true,		" x -- -x ",			[] ( PrimDS & ds ) { CellType x {}; return ds.Pop( x ) && ds.Push( CellType {} - x ); } },
+
+		{ "AND",	EPrimitive::kAnd,			2, 1, true,		" x y -- x_AND_y ",		[] ( PrimDS & ds ) { return ds.And(); } },
+		{ "OR",		EPrimitive::kOr,			2, 1, true,		" x y -- x_OR_y ",		[] ( PrimDS & ds ) { return ds.Or(); } },
+		{ "XOR",	EPrimitive::kXor,			2, 1, true,		" x y -- x_XOR_y ",		[] ( PrimDS & ds ) { return ds.Xor(); } },
+		{ "~",		EPrimitive::kInvert,		1, 1, true,		" x -- BIT_INV(x) ",	[] ( PrimDS & ds ) { return ds.Neg(); } },
+
+		{ "=",		EPrimitive::kEQ,			2, 1, true,		" x y -- x=y ",			[] ( PrimDS & ds ) { return ds.template EQ< SignedIntType >(); } },
+		{ "<>",		EPrimitive::kNE,			2, 1, true,		" x y -- x<>y ",		[] ( PrimDS & ds ) { return ds.template NE< SignedIntType >(); } },
+		{ "<",		EPrimitive::kLT,			2, 1, true,		" x y -- x<y ",			[] ( PrimDS & ds ) { return ds.template LT< SignedIntType >(); } },
+		{ "<=",		EPrimitive::kLE,			2, 1, true,		" x y -- x<=y ",		[] ( PrimDS & ds ) { return ds.template LE< SignedIntType >(); } },
+		{ ">",		EPrimitive::kGT,			2, 1, true,		" x y -- x>y ",			[] ( PrimDS & ds ) { return ds.template GT< SignedIntType >(); } },
+		{ ">=",		EPrimitive::kGE,			2, 1, true,		" x y -- x>=y ",		[] ( PrimDS & ds ) { return ds.template GE< SignedIntType >(); } },
+
+		{ "CELLS",	EPrimitive::kCells,			1, 1, true,		" n -- 8*n ",			[] ( PrimDS & ds ) { return ds.Cells(); } },
+		{ "CELL+",	EPrimitive::kCellPlus,		1, 1, true,		" addr -- addr+8",		[] ( PrimDS & ds ) { return ds.CellPlus(); } },
+
+		{ "@",		EPrimitive::kFetch,			1, 1, false,	" addr -- [addr] ",		[] ( PrimDS & ds ) { return ds.template ReadAt< CellType >(); } },
+		{ "!",		EPrimitive::kStore,			2, 0, false,	" x addr -- ",			[] ( PrimDS & ds ) { return ds.template WriteAt< CellType >(); } },
+		{ "C@",		EPrimitive::kCharFetch,		1, 1, false,	" c_addr -- [c_addr] ",	[] ( PrimDS & ds ) { return ds.template ReadAt< Char >(); } },
+		{ "C!",		EPrimitive::kCharStore,		2, 0, false,	" c c_addr -- ",		[] ( PrimDS & ds ) { return ds.template WriteAt< Char >(); } },
+		{ "C+!",	EPrimitive::kCharPlusStore,	2, 0, false,	" c c_addr -- ",		[] ( PrimDS & ds ) { return ds.template UpdateAt< Char >(); } },
+
+		{ "1+",		EPrimitive::kOnePlus,		1, 1, true,		" x -- x+1 ",			[] ( PrimDS & ds ) { return ds.template OnePlus< SignedIntType >(); } },
+		{ "1-",		EPrimitive::kOneMinus,		1, 1, true,		" x -- x-1 ",			[] ( PrimDS & ds ) { return ds.template OneMinus< SignedIntType >(); } },
+		{ "2+",		EPrimitive::kTwoPlus,		1, 1, true,		" x -- x+2 ",			[] ( PrimDS & ds ) { return ds.template TwoPlus< SignedIntType >(); } },
+		{ "2-",		EPrimitive::kTwoMinus,		1, 1, true,		" x -- x-2 ",			[] ( PrimDS & ds ) { return ds.template TwoMinus< SignedIntType >(); } },
+		{ "2*",		EPrimitive::kTwoTimes,		1, 1, true,		" x -- x*2 ",			[] ( PrimDS & ds ) { return ds.template TwoTimes< SignedIntType >(); } },
+
+		{ "0=",		EPrimitive::kEQ_0,			1, 1, true,		" x -- x=0 ",			[] ( PrimDS & ds ) { return ds.template EQ_0< SignedIntType >(); } },
+		{ "0<>",	EPrimitive::kNE_0,			1, 1, true,		" x -- x<>0 ",			[] ( PrimDS & ds ) { return ds.template NE_0< SignedIntType >(); } },
+		{ "0<",		EPrimitive::kLT_0,			1, 1, true,		" x -- x<0 ",			[] ( PrimDS & ds ) { return ds.template LT_0< SignedIntType >(); } },
+		{ "0<=",	EPrimitive::kLE_0,			1, 1, true,		" x -- x<=0 ",			[] ( PrimDS & ds ) { return ds.template LE_0< SignedIntType >(); } },
+		{ "0>",		EPrimitive::kGT_0,			1, 1, true,		" x -- x>0 ",			[] ( PrimDS & ds ) { return ds.template GT_0< SignedIntType >(); } },
+		{ "0>=",	EPrimitive::kGE_0,			1, 1, true,		" x -- x>=0 ",			[] ( PrimDS & ds ) { return ds.template GE_0< SignedIntType >(); } },
+
+		// The double-cell numbers d take two cells, the more significant one on top
+		{ "S>D",	EPrimitive::kS_2_D,			1, 2, true,		" n -- d ",				[] ( PrimDS & ds ) { return ds.S_2_D(); } },
+		{ "DNEGATE",EPrimitive::kDNegate,		2, 2, true,		" d -- -d ",			[] ( PrimDS & ds ) { return ds.DNegate(); } },
+		{ "D+",		EPrimitive::kDPlus,			4, 2, true,		" d1 d2 -- d1+d2 ",		[] ( PrimDS & ds ) { return ds.DPlus(); } },
+		{ "D-",		EPrimitive::kDMinus,		4, 2, true,		" d1 d2 -- d1-d2 ",		[] ( PrimDS & ds ) { return ds.DMinus(); } },
+		{ "D<",		EPrimitive::kDLess,			4, 1, true,		" d1 d2 -- d1<d2 ",		[] ( PrimDS & ds ) { return ds.DLess(); } },
+		{ "UM*",	EPrimitive::kUMStar,		2, 2, true,		" u1 u2 -- ud ",		[] ( PrimDS & ds ) { return ds.UMStar(); } },
+		{ "M*",		EPrimitive::kMStar,			2, 2, true,		" n1 n2 -- d ",			[] ( PrimDS & ds ) { return ds.MStar(); } },
+		{ "UM/MOD",	EPrimitive::kUMSlashMod,	3, 2, true,		" ud u -- rem quot ",	[] ( PrimDS & ds ) { return ds.UMSlashMod(); } },
+		{ "SM/REM",	EPrimitive::kSMSlashRem,	3, 2, true,		" d n -- rem quot ",	[] ( PrimDS & ds ) { return ds.SMSlashRem(); } },
+		{ "*/",		EPrimitive::kStarSlash,		3, 1, true,		" x y z -- (x*y)/z ",	[] ( PrimDS & ds ) { return ds.StarSlash(); } },
+		{ "*/MOD",	EPrimitive::kStarSlashMod,	3, 2, true,		" x y z -- rem quot ",	[] ( PrimDS & ds ) { return ds.StarSlashMod(); } },
+		{ "M*/",	EPrimitive::kMStarSlash,	4, 2, true,		" d1 n1 n2 -- d1*n1/n2 ",	[] ( PrimDS & ds ) { return ds.MStarSlash(); } },
+	} };
+
+
+	// The table is indexed by the opcodes
+	static_assert( [] { for( size_type i {}; i < kPrimitives.size(); ++ i ) if( kPrimitives[ i ].fOpCode != static_cast< EPrimitive >( i ) ) return false; return true; } (),
+						"kPrimitives should be ordered as EPrimitive" );
+
+
+	constexpr const TPrimitive & GetPrimitive( const EPrimitive op ) { return kPrimitives[ static_cast< size_type >( op ) ]; }
+
+	// Returns nullptr if the name is not of a primitive
+	constexpr const TPrimitive * FindPrimitive( const std::string_view name )
+	{
+		for( const auto & p : kPrimitives )
+			if( p.fName == name )
+				return & p;
+		return nullptr;
+	}
+
+
+	// Each primitive is a separate class, which calls its action directly (it can be inlined)
+	template < EPrimitive Op >
+	using PrimitiveWord = ExGenericStackOp< TForth, GetPrimitive( Op ).fAction >;
+
+
+	// Enters all the primitives to the current wordlist
+	inline void InsertPrimitives_2_Dict( TForth & forth )
+	{
+		[ & forth ] < size_type... I > ( std::index_sequence< I... > )
+		{
+			( forth.InsertWord_2_Dict( Name( kPrimitives[ I ].fName ), MakeWord< PrimitiveWord< static_cast< EPrimitive >( I ) > >( forth ), Name( kPrimitives[ I ].fComment ) ), ... );
+		} ( std::make_index_sequence< kPrimitives.size() >() );
+	}
+
+
+}	// The end of the BCForth namespace
+
@@ -65,6 +65,11 @@ namespace BCForth
 
 
 
+	public:
+
+		// The names of the words of this module (these can be entered before the words are made)
+		static inline const Names kManifest { "FRAND", "RAND", "FNRAND" };
+
 	public:
 
 		// Call to upload new words to the forth_comp
@@ -74,12 +79,12 @@ namespace BCForth
 			using RVG_Float = RandValGen< TForth, FloatType, std::uniform_real_distribution >;
 			using RVG_Int = RandValGen< TForth, SignedIntType, std::uniform_int_distribution >;
 
-			forth_comp.InsertWord_2_Dict( "FRAND",	std::make_unique< RVG_Float >( forth_comp, RVG_Float::RandDistr( 0.0, 1.0 ) ),	" -- fRand " );
-			forth_comp.InsertWord_2_Dict( "RAND",	std::make_unique< RVG_Int >( forth_comp, RVG_Int::RandDistr( 0, 100 ) ),	" -- rand " );
+			forth_comp.InsertWord_2_Dict( "FRAND",	MakeWord< RVG_Float >( forth_comp, RVG_Float::RandDistr( 0.0, 1.0 ) ),	" -- fRand " );
+			forth_comp.InsertWord_2_Dict( "RAND",	MakeWord< RVG_Int >( forth_comp, RVG_Int::RandDistr( 0, 100 ) ),	" -- rand " );
 
 
 			using RVG_Normal_Float = RandValGen< TForth, FloatType, std::normal_distribution >;                                 // mean, std
-			forth_comp.InsertWord_2_Dict( "FNRAND",	std::make_unique< RVG_Normal_Float >( forth_comp, RVG_Normal_Float::RandDistr( 0.0, 1.0 ) ),	" -- fNormRand " );
+			forth_comp.InsertWord_2_Dict( "FNRAND",	MakeWord< RVG_Normal_Float >( forth_comp, RVG_Normal_Float::RandDistr( 0.0, 1.0 ) ),	" -- fNormRand " );
 
 
 		}
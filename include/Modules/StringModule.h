@@ -15,6 +15,7 @@
 #include "Modules.h"
 #include <cstring>
 #include <algorithm>
+#include <limits>
 
 
 
@@ -29,6 +30,11 @@ namespace BCForth
 
 		using StDatType = TForthCompiler::DataStack::value_type;
 
+	public:
+
+		// The names of the words of this module (these can be entered before the words are made)
+		static inline const Names kManifest { "FILL", "ERASE", "BLANK", "MOVE", "DUMP", "COMPARE", "SEARCH", "ACCEPT" };
+
 	public:
 
 		// Call to upload new words to the forth_comp
@@ -45,7 +51,7 @@ namespace BCForth
 		void MemoryOperations( TForthCompiler & forth_comp )
 		{
 		
-			forth_comp.InsertWord_2_Dict( "FILL",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "FILL",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[] ( auto & ds )	{	StDatType addr, u, c;
 										return ds.Pop( c ) && ds.Pop( u ) && ds.Pop( addr ) ? std::memset( (void*)addr, (int)c, u ), true : false;
 									}	), " addr u char -- " );		
@@ -53,28 +59,30 @@ namespace BCForth
 
 
 
-			DirectTextModule( { ": ERASE ( addr u -- ) 0 FILL ;" } )( forth_comp );
-			DirectTextModule( { ": BLANK ( addr u -- ) BL FILL ;" } )( forth_comp );
+			forth_comp.InsertWord_2_Dict( "ERASE",	MakeWord< StackOp< TForth, void, Char *, CellType > >( forth_comp, 
+				[] ( const auto addr, const auto u ) { std::memset( addr, 0, u ); } ), " addr u -- " );
+
+			forth_comp.InsertWord_2_Dict( "BLANK",	MakeWord< StackOp< TForth, void, Char *, CellType > >( forth_comp, 
+				[] ( const auto addr, const auto u ) { std::memset( addr, kSpace, u ); } ), " addr u -- " );
 
 
-			forth_comp.InsertWord_2_Dict( "MOVE",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "MOVE",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[] ( auto & ds )	{	StDatType addr1, addr2, u;
 										return ds.Pop( u ) && ds.Pop( addr2 ) && ds.Pop( addr1 ) ? std::memmove( (void*)addr2, (void*)addr1, u ), true : false;
 									}	), " addr1 addr2 u (copy u from addr1 to addr2) -- " );	
 
 
 
-			forth_comp.InsertWord_2_Dict( "DUMP",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "DUMP",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[ & forth_comp ] ( auto & ds )	{	
 													StDatType addr, u;
 													if( ! ( ds.Pop( u ) && ds.Pop( addr ) ) ) return false;
 
 													auto & stream { forth_comp.GetOutStream() };
-													auto print_fun = forth_comp.ReadTheBase() == EIntCompBase::kHex ?	// in hex print on 2-wide-fields; for dec use 3-wide-fields
-														std::function{ [ & stream ] ( const RawByte b ) { stream << std::setfill( '0' ) << std::setw( 2 ) << std::uppercase << std::hex << +b << kSpace; } }
-																	:
-														std::function{ [ & stream ] ( const RawByte b ) { stream << std::setfill( '0' ) << std::setw( 3 ) << std::dec << +b << kSpace; } }
-																	;
+													// Each byte is printed in the current radix, on fields as wide as its max value (2 in hex, 3 in dec, etc.)
+													const auto base { forth_comp.ReadTheBase() };
+													const auto width { ToDigitsInBase( std::numeric_limits< RawByte >::max(), base ).size() };
+													auto print_fun = [ & stream, base, width ] ( const RawByte b ) { stream << ToDigitsInBase( b, base, width ) << kSpace; };
 
 													RawByte * ptr = reinterpret_cast< RawByte * >( addr );
 													const StDatType kSplitRow { 16 };
@@ -107,7 +115,7 @@ namespace BCForth
 
 			// Compare strings (memory byte-by-byte) beginning at addr1 and addr2 and to the min(u1,u2)
 			// Returns 0 if identical; else -1 if first non matching char in the first string has lesser value than in the second; +1 otherwise
-			forth_comp.InsertWord_2_Dict( "COMPARE",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "COMPARE",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[] ( auto & ds )	{	StDatType addr1, addr2, u1, u2;			
 										return ds.Pop( u2 ) && ds.Pop( addr2 ) && ds.Pop( u1 ) && ds.Pop( addr1 ) ? ds.Push( std::memcmp( reinterpret_cast< void * >( addr1 ), reinterpret_cast< void * >( addr2 ), std::min( u1, u2 ) ) ), true : false;
 									}	
@@ -118,7 +126,7 @@ namespace BCForth
 			// Search in the string at (addr1,u1) for occurence of a string at (addr2,u2)
 			// Returns, if found: addr3 of the first matching char, num of chars in the first string till the end, true
 			// Returns, if not found: addr3 == addr1, u1, false
-			forth_comp.InsertWord_2_Dict( "SEARCH",	std::make_unique< GenericStackOp< TForth > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "SEARCH",	MakeWord< GenericStackOp< TForth > >( forth_comp, 
 				[] ( auto & ds )	{	StDatType addr1, addr2, u1, u2;			
 										if( ! ( ds.Pop( u2 ) && ds.Pop( addr2 ) && ds.Pop( u1 ) && ds.Pop( addr1 ) ) ) return false;
 										if( auto it = std::search( (Char*)addr1, (Char*)addr1 + u1, (Char*)addr2, (Char*)addr2 + u2 ); it != (Char*)addr1 + u1 )
@@ -143,7 +151,7 @@ namespace BCForth
 			// 
 			// To read char-by-char, even with CR, use the KEY word
 			//
-			forth_comp.InsertWord_2_Dict( "ACCEPT",	std::make_unique< StackOp< TForth, CellType, Char *, CellType > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "ACCEPT",	MakeWord< StackOp< TForth, CellType, Char *, CellType > >( forth_comp, 
 
 				[ & forth_comp ] ( const auto addr, const auto maxLen ) 
 				{ 
@@ -30,6 +30,11 @@ namespace BCForth
 	class TimeModule : public TForthModule
 	{
 
+	public:
+
+		// The names of the words of this module (these can be entered before the words are made)
+		static inline const Names kManifest { "TIMER_START", "TIMER_END", "GET_TIME" };
+
 	public:
 
 		// Call to upload new time related words to the forth_comp
@@ -41,11 +46,11 @@ namespace BCForth
 			// : TT TIMER_START XXX TIMER_END . ;
 			// TT
 
-			forth_comp.InsertWord_2_Dict( "TIMER_START",	std::make_unique< StackOp< TForth, CellType > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "TIMER_START",	MakeWord< StackOp< TForth, CellType > >( forth_comp, 
 				[] () { return std::chrono::duration_cast< std::chrono::milliseconds >( timer::now().time_since_epoch() ).count(); } ), " -- time_pt_ms " );
 
 
-			forth_comp.InsertWord_2_Dict( "TIMER_END",	std::make_unique< StackOp< TForth, CellType, CellType > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "TIMER_END",	MakeWord< StackOp< TForth, CellType, CellType > >( forth_comp, 
 				[] ( const auto time_start ) { return std::chrono::duration_cast< std::chrono::milliseconds >( timer::now().time_since_epoch() ).count() - time_start; } ), " -- duration_ms " );
 
 
@@ -53,7 +58,7 @@ namespace BCForth
 
 
 			// Get time as a string in the format: Www Mmm dd hh:mm:ss yyyy
-			forth_comp.InsertWord_2_Dict( "GET_TIME",	std::make_unique< StackOp< TForth, CellType > >( forth_comp, 
+			forth_comp.InsertWord_2_Dict( "GET_TIME",	MakeWord< StackOp< TForth, CellType > >( forth_comp, 
 				[ & forth_comp ] () 
 				{  
 					using timer = std::chrono::system_clock;
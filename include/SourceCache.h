@@ -0,0 +1,422 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+#pragma once
+
+
+#include <cstdlib>
+#include <filesystem>
+#include <unordered_set>
+
+
+#include "ForthImage.h"
+#include "Primitives.h"
+#include "Tokenizer.h"
+
+
+
+
+namespace BCForth
+{
+
+
+	namespace fs = std::filesystem;
+
+
+
+	// INCLUDE and REQUIRE - a source file is compiled once, then its definitions are loaded from the cache,
+	// i.e. from a layer of the dictionary image (.fbc) made just after the file was compiled. The cached file
+	// is found by the hash of the text, of the words it is compiled on, and of the files it includes, so any
+	// change of these makes it compiled again. Only the definitions (with their data, the search order, the current
+	// wordlist and BASE) come from the cache, so a file is cached only if the words it runs outside its definitions
+	// make nothing else - one which prints, stores to an older variable, or leaves something on the stacks
+	// is compiled each time.
+	template < typename ForthComp >
+	class TSourceCacheFor
+	{
+		using Byte = RawByte;
+
+		static constexpr char	kMagic[ 8 ] { 'B', 'C', 'F', 'C', 'A', 'C', 'H', 'E' };
+
+		static constexpr std::uint64_t	kVersion { 3 };		// goes to the hash - the older caches kept the files with other effects, or no VALUE flags
+
+		ForthComp &		fForth;
+
+		fs::path		fCacheDir;		// nothing is cached if empty
+
+		std::unordered_set< Name >	fLoadedFiles;		// the files loaded in this session (REQUIRE skips them)
+
+		// A file with the hash of its text
+		struct Dependency
+		{
+			Name			fPath;
+			std::uint64_t	fHash {};
+		};
+
+		// A file being compiled
+		struct OpenFile
+		{
+			std::vector< Dependency >	fDeps;					// the files it includes
+			bool						fCacheable { true };	// false if one of them could not be cached
+		};
+
+		std::vector< OpenFile >		fOpenFiles;
+
+	public:
+
+		TSourceCacheFor( ForthComp & f ) : fForth( f ), fCacheDir( DefaultCacheDir() ) {}
+
+		void SetCacheDir( fs::path dir ) { fCacheDir = std::move( dir ); }
+
+		const fs::path & GetCacheDir( void ) const { return fCacheDir; }
+
+		// BCFORTH_CACHE_DIR, or the user's cache directory
+		static fs::path DefaultCacheDir( void )
+		{
+			if( const auto dir { std::getenv( "BCFORTH_CACHE_DIR" ) } )
+				return dir;
+			if( const auto dir { std::getenv( "XDG_CACHE_HOME" ) } )
+				return fs::path( dir ) / "bcforth";
+			if( const auto dir { std::getenv( "HOME" ) } )
+				return fs::path( dir ) / ".cache" / "bcforth";
+
+			std::error_code ec;
+			const auto tmp { fs::temp_directory_path( ec ) };
+			return ec ? fs::path() : tmp / "bcforth";
+		}
+
+	public:
+
+		// INCLUDE file_name, or REQUIRE file_name (the latter does nothing if the file has been already loaded)
+		void Include( const Name & file_name, const bool require )
+		{
+			std::error_code ec;
+			const auto canonical_path { fs::weakly_canonical( file_name, ec ) };
+			const Name path { ec ? file_name : canonical_path.string() };
+
+			if( require && fLoadedFiles.contains( path ) )
+				return;
+
+			const auto text { ReadFile( path ) };
+			if( ! text )
+				throw ForthError( "cannot open the file " + file_name );
+
+			fLoadedFiles.insert( path );
+
+			const auto text_hash { Hash( text->data(), text->size() ) };
+			for( auto & open_file : fOpenFiles )
+				open_file.fDeps.push_back( { path, text_hash } );
+
+			const auto cache_path { fCacheDir.empty() ? fs::path() : fCacheDir / ( ToHex( DictHash( text_hash ) ) + ".fbc" ) };
+
+			if( ! cache_path.empty() && LoadFromCache( cache_path ) )
+				return;
+
+			Compile( file_name, * text, cache_path );
+		}
+
+	private:
+
+		void Compile( const Name & file_name, const Name & text, const fs::path & cache_path )
+		{
+			const auto kBaseDefs { fForth.GetDefLog().size() };
+			const auto kNumRewinds { fForth.GetNumOfDictRewinds() };
+
+			fOpenFiles.emplace_back();
+
+			Names run_log;
+			const auto prev_run_log { fForth.SetRunLog( cache_path.empty() ? nullptr : & run_log ) };
+
+			const auto data_stack { StackContents( fForth.GetDataStack() ) };
+			const auto float_stack { fForth.HasFloatStack() ? StackContents( fForth.GetFloatStack() ) : decltype( StackContents( fForth.GetFloatStack() ) ) {} };
+
+			try
+			{
+				std::istringstream ss( text );
+				for( TForthReader reader; ss; fForth( reader( ss ) ) )
+					;
+				fForth.CheckEndOfSource( file_name );
+			}
+			catch( ... )
+			{
+				fForth.SetRunLog( prev_run_log );
+				fOpenFiles.pop_back();
+				throw;
+			}
+
+			fForth.SetRunLog( prev_run_log );
+
+			const auto open_file { std::move( fOpenFiles.back() ) };
+			fOpenFiles.pop_back();
+
+			if( cache_path.empty() )
+				return;
+
+			// Not cached if the words below were forgotten, or if the file did more than the layer keeps
+			if( ! open_file.fCacheable || fForth.GetNumOfDictRewinds() != kNumRewinds || ! OnlyDefines( run_log )
+				|| StackContents( fForth.GetDataStack() ) != data_stack 
+				|| ( fForth.HasFloatStack() && StackContents( fForth.GetFloatStack() ) != float_stack ) )
+			{
+				SetNotCacheable();
+				return;
+			}
+
+			const auto & deps { open_file.fDeps };
+
+			try
+			{
+				const auto layer { TForthImageFor< ForthComp >( fForth ).MakeLayer( kBaseDefs ) };
+
+				std::vector< Byte > bytes( kMagic, kMagic + sizeof( kMagic ) );
+				PutU64( bytes, deps.size() );
+				for( const auto & [ dep_path, dep_hash ] : deps )
+				{
+					PutU64( bytes, dep_path.size() );
+					bytes.insert( bytes.end(), dep_path.begin(), dep_path.end() );
+					PutU64( bytes, dep_hash );
+				}
+				bytes.insert( bytes.end(), layer.begin(), layer.end() );
+
+				WriteFile( cache_path, bytes );
+			}
+			catch( const ForthError & )
+			{
+				// Some words cannot be stored - the file will be compiled each time
+				SetNotCacheable();
+			}
+		}
+
+		// The file which includes the one just compiled cannot be cached either, since its layer would not repeat the other's effects
+		void SetNotCacheable( void )
+		{
+			if( ! fOpenFiles.empty() )
+				fOpenFiles.back().fCacheable = false;
+		}
+
+		// True if the words run outside the definitions (see TForthInterpreter::SetRunLog) only make what goes to the layer -
+		// the definitions with their data, the search order and BASE. The words defined by the user could do anything else.
+		bool OnlyDefines( const Names & run_log )
+		{
+			static const std::unordered_set< Name >	kContexts		{ ":", "VOCABULARY", "IMMEDIATE", "INCLUDE", "REQUIRE", "CHAR", "'" };
+			static const std::unordered_set< Name >	kDataWords		{ ",", "C,", "F,", "ALLOT", "ALIGN", ",\"" };
+			static const std::unordered_set< Name >	kOrderWords		{ "DEFINITIONS", "ALSO", "ONLY", "PREVIOUS", "FORTH", "HEX", "DEC" };
+
+			const auto kNumSystemDefs { std::max( fForth.GetDictFence(), fForth.GetNumOfNativeDefs() ) };
+
+			bool created {};		// the data must go to the words made by this file, not after the older ones
+
+			for( const auto & name : run_log )
+			{
+				if( name == "CREATE" )
+				{
+					created = true;
+					continue;
+				}
+
+				if( kContexts.contains( name ) )
+					continue;
+
+				if( kDataWords.contains( name ) )
+				{
+					if( ! created )
+						return false;
+					if( name == ",\"" )
+						continue;		// not a word, but a context sequence
+				}
+
+				const auto entry { fForth.GetWordEntry( name ) };
+				if( ! entry )
+					return false;
+
+				if( dynamic_cast< const VocabularyWord< TForth > * >( ( * entry )->fWordUP.get() ) != nullptr )
+					continue;		// it only changes the search order
+
+				if( ( * entry )->fDefSeq >= kNumSystemDefs )
+					return false;
+
+				if( ( * entry )->fWordIsDefining )
+				{
+					created = true;
+					continue;
+				}
+
+				if( kDataWords.contains( name ) || kOrderWords.contains( name ) )
+					continue;
+
+				if( const auto primitive { FindPrimitive( name ) }; primitive != nullptr && primitive->fPure )
+					continue;		// e.g. CELLS before ALLOT - what it leaves is checked on the stack
+
+				return false;
+			}
+
+			return true;
+		}
+
+		template < typename Stack >
+		static auto StackContents( const Stack & stack )
+		{
+			return std::vector< typename Stack::value_type >( stack.data(), stack.data() + stack.size() );
+		}
+
+		bool LoadFromCache( const fs::path & cache_path )
+		{
+			const auto bytes { ReadFile( cache_path ) };
+			if( ! bytes || bytes->size() < sizeof( kMagic ) || bytes->compare( 0, sizeof( kMagic ), kMagic, sizeof( kMagic ) ) != 0 )
+				return false;
+
+			// The included files must be the same as well
+			size_type pos { sizeof( kMagic ) };
+			std::vector< Dependency > deps;
+
+			const auto num_deps { GetU64( * bytes, pos ) };
+			if( ! num_deps )
+				return false;
+
+			for( auto i { * num_deps }; i -- > 0; )
+			{
+				const auto len { GetU64( * bytes, pos ) };
+				if( ! len || * len > bytes->size() - pos )
+					return false;
+
+				Dependency dep { bytes->substr( pos, * len ) };
+				pos += * len;
+
+				const auto dep_hash { GetU64( * bytes, pos ) };
+				const auto dep_text { ReadFile( dep.fPath ) };
+				if( ! dep_hash || ! dep_text || Hash( dep_text->data(), dep_text->size() ) != * dep_hash )
+					return false;
+
+				dep.fHash = * dep_hash;
+				deps.push_back( std::move( dep ) );
+			}
+
+			// A broken file leaves nothing
+			const auto mark { fForth.GetDictMark() };
+			try
+			{
+				TForthImageFor< ForthComp >( fForth ).LoadLayer( reinterpret_cast< const Byte * >( bytes->data() ) + pos, bytes->size() - pos, cache_path.string() );
+			}
+			catch( const ForthError & )
+			{
+				fForth.RewindDict( mark );
+				return false;
+			}
+
+			for( const auto & dep : deps )
+			{
+				fLoadedFiles.insert( dep.fPath );
+				for( auto & open_file : fOpenFiles )
+					open_file.fDeps.push_back( dep );
+			}
+
+			return true;
+		}
+
+	private:
+
+		// The hash of the file's text and of the state of the dictionary it is compiled on
+		std::uint64_t DictHash( std::uint64_t h )
+		{
+			auto add = [ & h ] ( const auto v ) { h = Hash( & v, sizeof( v ), h ); };
+			auto add_name = [ & h ] ( const std::string_view n ) { h = Hash( n.data(), n.size(), h ); h = Hash( "", 1, h ); };
+
+			add( kVersion );
+			add( sizeof( CellType ) );
+			add( FORTH_IS_CASE_INSENSITIVE );		// the names are read differently
+			add( fForth.HasFloatStack() );		// the float literals are compiled for one of the stacks
+			add( fForth.GetDefLog().size() );
+
+			for( typename ForthComp::WordListID wid {}; wid < fForth.GetNumOfWordLists(); ++ wid )
+			{
+				add_name( fForth.GetWordListName( wid ) );
+				for( const auto & [ name, entry ] : fForth.GetWordList( wid ) )
+				{
+					add_name( name );
+					add( entry.fDefSeq );
+					add( static_cast< unsigned >( entry.fWordIsImmediate ) | static_cast< unsigned >( entry.fWordIsDefining ) << 1 | static_cast< unsigned >( entry.fWordIsValue ) << 2 );
+				}
+			}
+
+			const auto & order { fForth.GetSearchOrder() };
+			for( size_type i {}; i < order.size(); ++ i )
+				add( order.data()[ i ] );
+			add( fForth.GetCurrent() );
+			add( fForth.GetSystemVars().fBase );
+
+			return h;
+		}
+
+		// FNV-1a
+		static std::uint64_t Hash( const void * p, const size_type n, std::uint64_t h = 14695981039346656037ull )
+		{
+			for( auto b { static_cast< const unsigned char * >( p ) }, e { b + n }; b != e; ++ b )
+				h = ( h ^ * b ) * 1099511628211ull;
+			return h;
+		}
+
+		static Name ToHex( const std::uint64_t v )
+		{
+			std::ostringstream os;
+			os << std::hex << std::setw( 16 ) << std::setfill( '0' ) << v;
+			return os.str();
+		}
+
+		static void PutU64( std::vector< Byte > & bytes, const std::uint64_t v )
+		{
+			const auto p { reinterpret_cast< const Byte * >( & v ) };
+			bytes.insert( bytes.end(), p, p + sizeof( v ) );
+		}
+
+		static std::optional< std::uint64_t > GetU64( const Name & bytes, size_type & pos )
+		{
+			std::uint64_t v {};
+			if( sizeof( v ) > bytes.size() - pos )
+				return std::nullopt;
+			std::memcpy( & v, bytes.data() + pos, sizeof( v ) );
+			pos += sizeof( v );
+			return v;
+		}
+
+		static std::optional< Name > ReadFile( const fs::path & path )
+		{
+			std::ifstream file( path, std::ios::binary | std::ios::ate );
+			if( ! file )
+				return std::nullopt;
+
+			Name bytes( static_cast< size_type >( file.tellg() ), '\0' );
+			file.seekg( 0 );
+			if( ! file.read( bytes.data(), bytes.size() ) )
+				return std::nullopt;
+
+			return bytes;
+		}
+
+		// The file appears at once, so other programs never read a half of it
+		static void WriteFile( const fs::path & path, const std::vector< Byte > & bytes )
+		{
+			std::error_code ec;
+			fs::create_directories( path.parent_path(), ec );
+
+			auto tmp_path { path };
+			tmp_path += ".tmp" + std::to_string( reinterpret_cast< std::uintptr_t >( & bytes ) );
+
+			if( std::ofstream file( tmp_path, std::ios::binary ); ! file || ! file.write( reinterpret_cast< const char * >( bytes.data() ), bytes.size() ) )
+				return;
+
+			if( fs::rename( tmp_path, path, ec ); ec )
+				fs::remove( tmp_path, ec );
+		}
+
+	};
+
+
+
+}	// The end of the BCForth namespace
+
@@ -0,0 +1,82 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+#pragma once
+
+
+
+#include "SystemWords.h"
+
+
+
+
+
+
+namespace BCForth
+{
+
+
+
+
+	// ------------------------
+	// The words of the floating-point stack (if the floats have their own stack)
+
+
+	// As ExGenericStackOp, but F gets both stacks: ( DataStack &, FloatStack & ) -> bool
+	template < typename Base, auto F >
+	class ExFloatStackOp : public TWord< Base >
+	{
+		using TWord< Base >::GetDataStack;
+		using TWord< Base >::GetForth;
+
+	public:
+
+		ExFloatStackOp( Base & f ) : TWord< Base >( f ) {}
+
+	public:
+
+		void operator () ( void ) override
+		{
+			if( F( GetDataStack(), GetForth().GetFloatStack() ) == false )
+				throw ForthError( "floating-point stack underflow or overflow" );
+		}
+
+	};
+
+
+
+	// F, - as , but the value comes from the floating-point stack
+	template < typename Base >
+	class FloatComma : public Comma< Base, CellType >
+	{
+		using Word = TWord< Base >;
+
+	public:
+
+		FloatComma( Base & f ) : Comma< Base, CellType >( f ) {}
+
+	public:
+
+		void operator () ( void ) override
+		{
+			if( FloatType val {}; ! Word::GetForth().GetFloatStack().Pop( val ) || ! Word::GetDataStack().Push( BlindValueReInterpretation< CellType >( val ) ) )
+				throw ForthError( "floating-point stack underflow or overflow" );
+
+			Comma< Base, CellType >::operator () ();
+		}
+
+	};
+
+
+
+
+}	// The end of the BCForth namespace
+
+
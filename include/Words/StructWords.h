@@ -13,6 +13,7 @@
 
 
 #include "Words.h"
+#include <memory_resource>
 
 
 
@@ -47,7 +48,7 @@ namespace BCForth
 	public:
 
 		using WordPtr	= typename Base::WordPtr;
-		using WordsVec	= std::vector< WordPtr >;
+		using WordsVec	= std::pmr::vector< WordPtr >;		// kept in the node arena, next to the nodes
 
 	private:
 
@@ -55,7 +56,7 @@ namespace BCForth
 
 	public:
 
-		CompoWord( Base & f ) : StructuralWord< Base >( f ) {}
+		CompoWord( Base & f ) : StructuralWord< Base >( f ), fWordsVec( & f.GetNewNodeArena() ) {}
 
 	public:
 
@@ -243,11 +244,164 @@ namespace BCForth
 
 		I_LOOP( Base & f, const DO_LOOP< Base > & my_loop ) : TWord< Base >( f ), fMyLoopNode( my_loop ) {}
 
+	public:
+
+		const DO_LOOP< Base > &	GetLoopNode( void ) const { return fMyLoopNode; }
+
+	public:
+
+		void operator () ( void ) override
+		{
+			if( GetDataStack().Push( static_cast< CellType >( fMyLoopNode.GetIndex() ) ) == false )
+				throw ForthError( "stack overflow" );
+		}
+
+	};
+
+
+
+
+
+
+
+	// Local variables, as in
+	//
+	// : X1X2 {: a b d -- x1 x2 :}		d SQRT b FNEG ...	;
+	//
+	// The {: ... :} declaration opens a frame of fixed slots on the return stack.
+	// The first fNumArgs slots are initialized from the data stack (the last argument
+	// is on top), the remaining ones, i.e. declared after |, are set to 0.
+	// The rest of the word's definition goes to the body branch, executed with the frame on.
+	template < typename Base >
+	class LOCALS_FRAME : public StructuralWord< Base >
+	{
+		using DataStack = typename Base::DataStack;
+		using RetStack = typename Base::RetStack;
+		using TWord< Base >::GetDataStack;
+		using TWord< Base >::GetForth;
+
+		using CW = CompoWord< Base >;
+
+		CW	fBodyNodes;
+
+		const size_type		fNumArgs {};		// slots initialized from the data stack
+		const size_type		fNumLocals {};		// all slots in the frame
+
+	public:
+
+		CW &	GetBodyNodes( void ) { return fBodyNodes; }
+
+		size_type	GetNumOfArgs( void ) const { return fNumArgs; }
+		size_type	GetNumOfLocals( void ) const { return fNumLocals; }
+
+	public:
+
+		LOCALS_FRAME( Base & f, const size_type num_args, const size_type num_locals )
+			: StructuralWord< Base >( f ), fBodyNodes( f ), fNumArgs( num_args ), fNumLocals( num_locals )
+		{
+			assert( fNumArgs <= fNumLocals );
+		}
+
+	public:
+
+		void operator () ( void ) override
+		{
+			auto & ds { GetDataStack() };
+			auto & rs { GetForth().GetRetStack() };
+
+			if( ds.size() < fNumArgs )
+				throw ForthError( "unexpectedly empty stack" );
+
+			if( rs.size() + fNumLocals > rs.max_size() )
+				throw ForthError( "return stack overflow" );
+
+			const auto kPrevFrame { GetForth().GetLocalsFrame() };
+			const auto kFrame { rs.size() };
+
+			// Move the arguments, preserving their order
+			const auto kArgsPos { ds.size() - fNumArgs };
+			for( size_type i {}; i < fNumArgs; ++ i )
+				rs.Push( ds.data()[ kArgsPos + i ] );
+			ds.Truncate( kArgsPos );
+
+			for( auto i { fNumArgs }; i < fNumLocals; ++ i )
+				rs.Push( typename RetStack::value_type {} );
+
+			GetForth().SetLocalsFrame( kFrame );
+
+			try
+			{
+				fBodyNodes();
+			}
+			catch( ... )
+			{
+				// Restore the caller's frame and let the exception go to upper layers
+				rs.Truncate( kFrame );
+				GetForth().SetLocalsFrame( kPrevFrame );
+				throw;
+			}
+
+			rs.Truncate( kFrame );
+			GetForth().SetLocalsFrame( kPrevFrame );
+		}
+
+	};
+
+
+	// Push a value of a local variable (i.e. its slot in the current frame)
+	template < typename Base >
+	class LocalFetch : public TWord< Base >
+	{
+		using TWord< Base >::GetDataStack;
+		using TWord< Base >::GetForth;
+
+		const size_type		fSlot {};
+
+	public:
+
+		LocalFetch( Base & f, const size_type slot ) : TWord< Base >( f ), fSlot( slot ) {}
+
+	public:
+
+		size_type	GetSlot( void ) const { return fSlot; }
+
+	public:
+
+		void operator () ( void ) override
+		{
+			if( GetDataStack().Push( GetForth().GetRetStack().data()[ GetForth().GetLocalsFrame() + fSlot ] ) == false )
+				throw ForthError( "stack overflow" );
+		}
+
+	};
+
+
+	// TO name - pop a value and store it in the slot of a local variable
+	template < typename Base >
+	class LocalStore : public TWord< Base >
+	{
+		using DataStack = typename Base::DataStack;
+		using TWord< Base >::GetDataStack;
+		using TWord< Base >::GetForth;
+
+		const size_type		fSlot {};
+
+	public:
+
+		LocalStore( Base & f, const size_type slot ) : TWord< Base >( f ), fSlot( slot ) {}
+
+	public:
+
+		size_type	GetSlot( void ) const { return fSlot; }
+
 	public:
 
 		void operator () ( void ) override
 		{
-			GetDataStack().Push( static_cast< CellType >( fMyLoopNode.GetIndex() ) );
+			if( typename DataStack::value_type t {}; GetDataStack().Pop( t ) )
+				GetForth().GetRetStack().data()[ GetForth().GetLocalsFrame() + fSlot ] = t;
+			else
+				throw ForthError( "unexpectedly empty stack" );
 		}
 
 	};
@@ -324,8 +478,18 @@ namespace BCForth
 
 		enum class EBeginLoopType { kAgain, kUntil, kWhileRepeat, kExit };
 
+	private:
+
+		EBeginLoopType	fLoopType { EBeginLoopType::kAgain };
+
+	public:
+
+		EBeginLoopType GetLoopType( void ) const { return fLoopType; }
+
 		void SetLoopType( EBeginLoopType ltp ) 
 		{
+			fLoopType = ltp;
+
 			switch( ltp )
 			{
 			case EBeginLoopType::kAgain:
@@ -393,6 +557,10 @@ namespace BCForth
 
 		EXIT_BEGIN_LOOP( Base & f, BEGIN_LOOP< Base > & my_loop ) : TWord< Base >( f ), fMyBeginNode( my_loop ) {}
 
+	public:
+
+		BEGIN_LOOP< Base > &	GetBeginNode( void ) const { return fMyBeginNode; }
+
 	public:
 
 		void operator () ( void ) override
@@ -115,14 +115,14 @@ namespace BCForth
 			if( auto word_entry = GetForth().GetWordEntry( fValueName ) )
 			{
 
-				if( auto * compo_wrd = dynamic_cast< CompoWord< Base > * >(  ( * word_entry )->fWordUP.get() ); compo_wrd && compo_wrd->GetWordsVec().size() > 0 )	// Ok, the word is found but check if this is a proper node
+				if( auto * compo_wrd = ( * word_entry )->fWordIsValue ? dynamic_cast< CompoWord< Base > * >(  ( * word_entry )->fWordUP.get() ) : nullptr; compo_wrd && compo_wrd->GetWordsVec().size() > 0 )	// Ok, the word is found but check if this is a proper node
 
 					if( auto * val_array = dynamic_cast< RawByteArray< Base > * >(  compo_wrd->GetWordsVec()[ 0 ] ) )	// Access the array in the compo word				
 
 						if( typename DataStack::value_type val {}; GetDataStack().Pop( val ) )		// Ok, try to pop the stack 
 						{							
-							assert( val_array->GetContainer().size() == sizeof( CellType ) );
-							* reinterpret_cast< typename DataStack::value_type * >( val_array->GetContainer().data() ) = val;
+							assert( val_array->GetData().size() == sizeof( CellType ) );
+							std::memcpy( val_array->GetData().data(), & val, sizeof( val ) );
 							return;
 						}
 						else
@@ -131,7 +131,7 @@ namespace BCForth
 						}
 
 
-				throw ForthError( "This word cannot be used in this context" );
+				throw ForthError( " TO used with " + fValueName + " which is not a VALUE" );
 
 			}
 			else
@@ -176,21 +176,11 @@ namespace BCForth
 		void operator () ( void ) override
 		{
 
-			// CellVal node is on the node repo, whereas value to set is on the data stack - go for them
+			// The value goes at HERE - i.e. to the data of the last CREATEd word, if nothing else was allotted after it
 			if( typename DataStack::value_type val {}; GetDataStack().Pop( val ) )
 			{
-
-				if( const auto & nrepo { GetForth().GetNodeRepo() }; nrepo.size() > 0 )
-
-					if( auto * cell_val_node = dynamic_cast< RawByteArray< Base > * >( nrepo[ nrepo.size() - 1 ].get() ) )
-					{
-						PushValTo( cell_val_node->GetContainer(), static_cast< VAL_TYPE >( val ) );
-						return;
-					}
-
-
-				throw ForthError( "no preceding CREATE to , (comma)" );
-
+				const auto v { static_cast< VAL_TYPE >( val ) };
+				std::memcpy( GetForth().AllotData( sizeof( v ) ), & v, sizeof( v ) );
 			}
 			else
 			{
@@ -223,21 +213,12 @@ namespace BCForth
 
 		void operator () ( void ) override
 		{
-			if( const auto & nrepo { GetForth().GetNodeRepo() }; nrepo.size() > 0 )
-
-				if( auto * cell_val_node = dynamic_cast< RawByteArray< Base > * >( nrepo[ nrepo.size() - 1 ].get() ) )
-				{
-						
-					auto str_len { fStr.length() };
-					assert( str_len <= 255 );
-					PushValTo( cell_val_node->GetContainer(), static_cast< RawByte >( str_len ) );
-					std::for_each( fStr.begin(), fStr.end(), [ & arr = cell_val_node->GetContainer() ] ( const auto c ) { PushValTo( arr, static_cast< RawByte >( c ) ); } );
-
-					return;
-				}
-
-
-			throw ForthError( "no preceding CREATE to ,\" (comma-quote)" );
+			// The counted string at HERE
+			const auto str_len { fStr.length() };
+			assert( str_len <= 255 );
+			const auto p { GetForth().AllotData( str_len + 1 ) };
+			p[ 0 ] = static_cast< RawByte >( str_len );
+			std::transform( fStr.begin(), fStr.end(), p + 1, [] ( const auto c ) { return static_cast< RawByte >( c ); } );
 		}
 
 
@@ -246,7 +227,7 @@ namespace BCForth
 
 
 
-	// Allocate n bytes for the array - however we use the cell-type array
+	// Allocate n bytes at HERE (or give back the last -n ones)
 	// Used in context like this 
 	// 
 	// CREATE DATA  100 ALLOT
@@ -274,21 +255,13 @@ namespace BCForth
 
 		void operator () ( void ) override
 		{	
-			// CellVal node is on the node repo, whereas num of bytes to allocate is on the data stack - go for them
+			// The bytes follow the prior , etc. - so the data of the last CREATEd word grow
 			if( typename DataStack::value_type size_2_alloc_in_bytes {}; GetDataStack().Pop( size_2_alloc_in_bytes ) )
 			{
-
-				if( const auto & nrepo { GetForth().GetNodeRepo() }; nrepo.size() > 0 )
-
-					if( auto * cell_val_node = dynamic_cast< RawByteArray< Base > * >( nrepo[ nrepo.size() - 1 ].get() ) )
-					{
-						cell_val_node->GetContainer().resize( cell_val_node->GetContainer().size() + size_2_alloc_in_bytes );	// append the new size, i.e. keep the previous allocations
-						return;																									// this makes possible interaction with prior ,
-					}
-
-
-				throw ForthError( "no preceding CREATE to ALLOT" );
-
+				if( const auto n { static_cast< SignedIntType >( size_2_alloc_in_bytes ) }; n < 0 )
+					GetForth().FreeData( static_cast< size_type >( - n ) );
+				else
+					GetForth().AllotData( static_cast< size_type >( n ) );
 			}
 			else
 			{
@@ -333,7 +306,7 @@ namespace BCForth
 		{
 			// When Create executes the RawByteArray node is created. It needs to be associated with the subsequent
 			// word whose name is next in the input stream after the defining word (i.e. the one containing this CREATE)
-			GetForth().Insert_2_NodeRepo( std::make_unique< RawByteArray< Base > >( GetForth() ) );
+			GetForth().Insert_2_NodeRepo( MakeWord< RawByteArray< Base > >( GetForth() ) );
 		}
 
 
@@ -356,6 +329,10 @@ namespace BCForth
 
 		Abort( Base & f, Name s = "" ) : TWord< Base >( f ), fText( s ) {}
 
+	public:
+
+		const Name &	GetText( void ) const { return fText; }
+
 	public:
 
 		void operator () ( void ) override
@@ -431,6 +408,10 @@ namespace BCForth
 
 		Postpone( Base & f, const WordPtr w_ptr ) : TWord< Base >( f ), fWordPtr( w_ptr ) {}
 
+	public:
+
+		WordPtr		GetWordPtr( void ) const { return fWordPtr; }
+
 	public:
 
 		// Do an exception ** when compiling an immediate word ** with some of its sub-words
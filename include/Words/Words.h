@@ -13,6 +13,7 @@
 
 
 #include <iostream>
+#include <cstddef>
 #include <iomanip>
 #include <string>
 #include <vector>
@@ -22,10 +23,12 @@
 #include <iterator>
 #include <functional>
 #include <fstream>
+#include <span>
 
 
 #include "BaseDefinitions.h"
 #include "TheStack.h"
+#include "NodeArena.h"
 
 
 
@@ -76,6 +79,21 @@ namespace BCForth
 		TWord( Base & f ) : fForth( f ) {}
 		virtual ~TWord() = default;
 
+	public:
+
+		// All nodes go to the node arena of their Forth, one after another, and they are released in bulk
+		// when the dictionary is rewound (or with the whole Forth) - so a single delete only destroys a node,
+		// unless the nodes of the garbage words are reclaimed, then the memory goes back to the arena.
+		// Hence a node is made only by MakeWord, which passes the arena of the Forth the node is made for.
+		static void * operator new( std::size_t size ) = delete;
+		static void * operator new( std::size_t size, TNodeArena & arena ) { return arena.allocate( size, alignof( std::max_align_t ) ); }
+		static void operator delete( void *, TNodeArena & ) noexcept {}		// the constructor threw - the arena keeps the memory until rewound
+		static void operator delete( void * p, std::size_t size ) noexcept 
+		{ 
+			if( const auto arena { Base::GetRecyclingArena() } )
+				arena->deallocate( p, size, alignof( std::max_align_t ) );
+		}
+
 	public:
 
 
@@ -99,6 +117,16 @@ namespace BCForth
 
 
 
+	// Makes the node W for the Forth f (always the first argument of the constructor of a node), in its node arena
+	template < typename W, typename F, typename ... Args >
+	std::unique_ptr< W > MakeWord( F & f, Args && ... args )
+	{
+		return std::unique_ptr< W >( new ( f.GetNewNodeArena() ) W( f, std::forward< Args >( args ) ... ) );
+	}
+
+
+
+
 	// Generic operation that affects the data stack
 	// This is useful if the supplied u_op lambda has a non-empty caption
 	template < typename Base >
@@ -273,6 +301,60 @@ namespace BCForth
 
 
 
+	// Converts v to the digits 0-9A-Z of the radix 2-36, left-padded with 0 up to min_width
+	inline Name ToDigitsInBase( std::uintmax_t v, const int base, const size_type min_width = 1 )
+	{
+		assert( base >= kMinBase && base <= kMaxBase );
+
+		Name digits;
+		do
+		{
+			const auto d { static_cast< int >( v % base ) };
+			digits += static_cast< Letter >( d < 10 ? '0' + d : 'A' + d - 10 );
+			v /= base;
+		}
+		while( v != 0 );
+
+		if( digits.size() < min_width )
+			digits.append( min_width - digits.size(), '0' );
+
+		std::reverse( digits.begin(), digits.end() );
+		return digits;
+	}
+
+
+	// Outputs v in the radix 2-36. The radices 8, 10 and 16 are left to the stream (with the 0 and 0x prefixes as before),
+	// the others are converted by ToDigitsInBase. The floating-point values are not affected by the radix.
+	template < typename T >
+	void PutInBase( std::ostream & o, const T v, const EIntCompBase base )
+	{
+		if constexpr( std::is_floating_point_v< T > )
+		{
+			o << v;
+		}
+		else
+		{
+			if( base == EIntCompBase::kOct || base == EIntCompBase::kDec || base == EIntCompBase::kHex )
+			{
+				o << std::setbase( base ) << ( base == EIntCompBase::kDec ? std::noshowbase : std::showbase ) << v;
+				return;
+			}
+
+			o << std::dec << std::noshowbase;
+
+			if constexpr( std::is_signed_v< T > )
+				if( v < 0 )
+				{
+					o << '-' << ToDigitsInBase( std::uintmax_t() - static_cast< std::uintmax_t >( v ), base );
+					return;
+				}
+
+			o << ToDigitsInBase( static_cast< std::uintmax_t >( v ), base );
+		}
+	}
+
+
+
 	// Print the entire stack not changing its content - for diagnostic
 	template < typename Base, typename DispType >
 	class Stack_Dump : public TWord< Base >
@@ -296,9 +378,8 @@ namespace BCForth
 		{
 			const auto ds { GetDataStack().data() };
 			const auto base { GetForth().ReadTheBase() };
-			fOutStream << std::setbase( base ) << ( base == EIntCompBase::kDec ? std::noshowbase : std::showbase );
-			std::transform( ds, ds + GetDataStack().size(),	std::ostream_iterator< DispType >( fOutStream, fSeparator.c_str() ), 
-							[] ( const auto & v ) { return BlindValueReInterpretation< DispType >( v ); } );
+			std::for_each( ds, ds + GetDataStack().size(), 
+							[ this, base ] ( const auto & v ) { PutInBase( fOutStream, BlindValueReInterpretation< DispType >( v ), base ); fOutStream << fSeparator; } );
 			fOutStream << fEndMark;
 		}
 
@@ -340,10 +421,14 @@ namespace BCForth
 		void operator () ( void ) override	
 		{
 			assert( sizeof( value_type ) <= sizeof( typename DataStack::value_type ) );
+			bool pushed {};
 			if constexpr ( std::is_same< value_type, Name >::value )
-				GetDataStack().Push( BlindValueReInterpretation< CellType >( fData.data() ) ), GetDataStack().Push( BlindValueReInterpretation< CellType >( fData.size() ) );	// addr n
+				pushed = GetDataStack().Push( BlindValueReInterpretation< CellType >( fData.data() ) ) && GetDataStack().Push( BlindValueReInterpretation< CellType >( fData.size() ) );	// addr n
 			else
-				GetDataStack().Push( BlindValueReInterpretation< CellType >( fData ) );
+				pushed = GetDataStack().Push( BlindValueReInterpretation< CellType >( fData ) );
+
+			if( ! pushed )
+				throw ForthError( "stack overflow" );
 		}
 
 	};
@@ -362,6 +447,29 @@ namespace BCForth
 	using DblValWord = TValFor< Base, FloatType >;
 
 
+	// A float literal, if the floats have their own stack
+	template < typename Base >
+	class FloatValWord : public TValFor< Base, FloatType >
+	{
+		using TValFor< Base, FloatType >::fData;
+		using TWord< Base >::GetForth;
+
+	public:
+
+		FloatValWord( Base & f, FloatType v = FloatType() ) : TValFor< Base, FloatType >( f, v ) {}
+
+	public:
+
+		// Push on the floating-point stack
+		void operator () ( void ) override
+		{
+			if( GetForth().GetFloatStack().Push( fData ) == false )
+				throw ForthError( "floating-point stack overflow" );
+		}
+
+	};
+
+
 	template < typename Base >
 	using CellValWord = TValFor< Base, CellType >;
 
@@ -401,8 +509,7 @@ namespace BCForth
 		{
 			if( typename DataStack::value_type t {}; GetDataStack().Pop( t ) )
 			{
-				const auto base { GetForth().ReadTheBase() };
-				fOutStream << std::setbase( base ) << ( base == EIntCompBase::kDec ? std::noshowbase : std::showbase ) << BlindValueReInterpretation< DispType >( t );
+				PutInBase( fOutStream, BlindValueReInterpretation< DispType >( t ), GetForth().ReadTheBase() );
 			}
 			else
 			{
@@ -433,8 +540,7 @@ namespace BCForth
 		{
 			if( typename DataStack::value_type t {}; GetDataStack().Peek( t ) )
 			{
-				const auto base { GetForth().ReadTheBase() };
-				fOutStream << std::setbase( base ) << ( base == EIntCompBase::kDec ? std::noshowbase : std::showbase ) << BlindValueReInterpretation< DispType >( t );
+				PutInBase( fOutStream, BlindValueReInterpretation< DispType >( t ), GetForth().ReadTheBase() );
 			}
 			else
 			{
@@ -445,6 +551,60 @@ namespace BCForth
 	};
 
 
+	// Pop and print the double-cell number on top of the data stack - as . does, if it fits in a cell
+	template < typename Base >
+	class D_Dot : public Dot< Base, SignedIntType >
+	{
+		using DataStack = typename Base::DataStack;
+		using TWord< Base >::GetDataStack;
+		using TWord< Base >::GetForth;
+
+		using Dot< Base, SignedIntType >::fOutStream;
+
+		using DC = TDoubleCellFor< CellType >;
+
+	public:
+
+		D_Dot( Base & f, std::ostream & o ) : Dot< Base, SignedIntType >( f, o ) {}
+
+	public:
+
+		void operator () ( void ) override
+		{
+			CellType lo {}, hi {};
+			if( ! GetDataStack().Pop( hi ) || ! GetDataStack().Pop( lo ) )
+				throw ForthError( "unexpectedly empty stack" );
+
+			const auto base { GetForth().ReadTheBase() };
+
+			if( DC::FromCell( lo ).second == hi )
+			{
+				PutInBase( fOutStream, BlindValueReInterpretation< SignedIntType >( lo ), base );
+				return;
+			}
+
+			// As ., the radices 8 and 16 show the bits of the cells, the others the sign
+			const bool neg { DC::IsNeg( hi ) && base != EIntCompBase::kOct && base != EIntCompBase::kHex };
+			if( neg )
+				std::tie( lo, hi ) = DC::Negate( lo, hi );
+
+			// The digits go from the least significant one, with the letters and prefixes of the stream for 8 and 16
+			Name digits;
+			for( ; lo != 0 || hi != 0; )
+			{
+				const auto [ q_hi, r_hi ] { std::pair( hi / base, hi % base ) };
+				const auto [ q_lo, r ] { DC::Div( lo, r_hi, base ) };
+				digits += static_cast< Letter >( r < 10 ? '0' + r : ( base == EIntCompBase::kHex ? 'a' : 'A' ) + r - 10 );
+				lo = q_lo, hi = q_hi;
+			}
+			std::reverse( digits.begin(), digits.end() );
+
+			fOutStream << ( neg ? "-" : "" ) << ( base == EIntCompBase::kHex ? "0x" : base == EIntCompBase::kOct ? "0" : "" ) << digits;
+		}
+
+	};
+
+
 
 	// Just display the contained text
 	template < typename Base >
@@ -477,14 +637,28 @@ namespace BCForth
 		using DataStack = typename Base::DataStack;
 		using TWord< Base >::GetDataStack;
 
+	public:
+
+		// Tells which of the words made this one (its action is a lambda, so it cannot be recognized otherwise)
+		enum class EQuoteKind : unsigned char { kDotQuote, kSQuote, kCQuote };
+
+	private:
 
 		std::function< bool ( const Name &, DataStack & ) >	fQuoteOp;
 
 		Name		fText;
 
+		EQuoteKind	fKind {};
+
+	public:
+
+		QuoteSuite( Base & f, Name s, auto u_op, EQuoteKind kind = EQuoteKind::kDotQuote ) : TWord< Base >( f ), fQuoteOp( u_op ), fText( s ), fKind( kind ) {}
+
 	public:
 
-		QuoteSuite( Base & f, Name s, auto u_op ) : TWord< Base >( f ), fText( s ), fQuoteOp( u_op ) {}
+		const Name &	GetText( void ) const { return fText; }
+
+		EQuoteKind		GetKind( void ) const { return fKind; }
 
 	public:
 
@@ -502,51 +676,160 @@ namespace BCForth
 
 
 
-	// Similar to TValFor but used to store an array
-	// Provides: allocate, access, clear, etc.
-	template < typename Base, typename VType >
-	class TDataContainerFor : public TWord< Base >
+	// The data field of a CREATEd word (or of PAD) - its bytes are in the data space of the Forth, so their address never 
+	// changes. The field of the last CREATEd word grows with ALLOT, , etc. (see TForth::AllotData).
+	template < typename Base >
+	class RawByteArray : public TWord< Base >
 	{
 
 		using DataStack = typename Base::DataStack;
 		using TWord< Base >::GetDataStack;
 
-		using ContainerType = std::vector< VType >;
+		using TWord< Base >::GetForth;
 
-		ContainerType	fContainer {};
+		RawByte *		fData {};
+		size_type		fSize {};
 
 	public:
 
-		using value_type	= typename ContainerType::value_type;
-		using size_type		= typename ContainerType::size_type;
+		// An empty field at the aligned HERE - the data allotted from now on go to it
+		RawByteArray( Base & f ) : TWord< Base >( f ), fData( f.AlignData() )
+		{
+			f.SetLastDataField( this );
+		}
 
-		TDataContainerFor( Base & f, const size_type init_alloc_size = size_type() ) : TWord< Base >( f ), fContainer( init_alloc_size )
+		// The n bytes at once
+		RawByteArray( Base & f, const size_type n ) : RawByteArray( f )
 		{
-			static_assert( sizeof( value_type ) <= sizeof( typename DataStack::value_type ) );
-			assert( fContainer.size() == init_alloc_size );
+			f.AllotData( n );
 		}
 
-	public:
+		~RawByteArray()
+		{
+			GetForth().DropDataField( this );
+		}
 
+	public:
 
-		ContainerType & GetContainer( void ) { return fContainer; }
+		std::span< RawByte > GetData( void ) const { return { fData, fSize }; }
 
+		// Only as the data space grows (or shrinks) at the end of the field
+		void Resize( const size_type n ) { fSize = n; }
 
 	public:
 
-		// Push the address of the data buffer onto the data stack
+		// Push the address of the data onto the data stack
 		void operator () ( void ) override	
 		{
-			assert( fContainer.size() > 0 );
-			GetDataStack().Push( (typename DataStack::value_type) fContainer.data() );
+			if( ! GetDataStack().Push( reinterpret_cast< typename DataStack::value_type >( fData ) ) )
+				throw ForthError( "stack overflow" );
+		}
+
+	};
+
+
+
+
+	// The word made by VOCABULARY - it replaces the top of the search order with its wordlist
+	template < typename Base >
+	class VocabularyWord : public TWord< Base >
+	{
+		using TWord< Base >::GetForth;
+
+		using WordListID = typename Base::WordListID;
+
+		const WordListID	fWordList {};
+
+	public:
+
+		VocabularyWord( Base & f, const WordListID wid ) : TWord< Base >( f ), fWordList( wid ) {}
+
+	public:
+
+		WordListID	GetWordList( void ) const { return fWordList; }
+
+	public:
+
+		void operator () ( void ) override
+		{
+			GetForth().SetSearchOrderTop( fWordList );
+		}
+
+	};
+
+
+
+	// The word made by MARKER - it removes itself and all the words defined after it
+	template < typename Base >
+	class Marker : public TWord< Base >
+	{
+		using TWord< Base >::GetForth;
+
+		using DictMark = typename Base::DictMark;
+
+		const DictMark	fMark;
+
+	public:
+
+		Marker( Base & f, DictMark mark ) : TWord< Base >( f ), fMark( std::move( mark ) ) {}
+
+	public:
+
+		const DictMark &	GetMark( void ) const { return fMark; }
+
+	public:
+
+		// A word cannot remove itself while it runs, so it only requests the rewind
+		void operator () ( void ) override
+		{
+			GetForth().RequestDictRewind( fMark );
 		}
 
 	};
 
 
-	// Partial specialization
+
+	// A word of a module, which has not been made yet - it takes the place of the real word in the dictionary,
+	// which is made (with all the words of its module) on the first call, or with REQUIRE-MODULE
 	template < typename Base >
-	using RawByteArray = TDataContainerFor< Base, RawByte >;
+	class LazyWord : public TWord< Base >
+	{
+		using TWord< Base >::GetForth;
+
+		using WordPtr = typename Base::WordPtr;
+		using WordUP = typename Base::WordUP;
+
+		const size_type		fModule {};
+
+		WordUP				fRealWord;
+
+	public:
+
+		LazyWord( Base & f, const size_type module ) : TWord< Base >( f ), fModule( module ) {}
+
+	public:
+
+		size_type	GetModule( void ) const { return fModule; }
+
+		WordPtr		GetRealWord( void ) const { return fRealWord.get(); }
+
+		void		SetRealWord( WordUP wp ) { fRealWord = std::move( wp ); }
+
+	public:
+
+		void operator () ( void ) override
+		{
+			if( ! fRealWord )
+			{
+				GetForth().RequireModule( fModule );
+				if( ! fRealWord )
+					throw ForthError( "the module " + GetForth().GetModuleName( fModule ) + " does not make all the words of its manifest" );
+			}
+
+			( * fRealWord )();
+		}
+
+	};
 
 
 
@@ -14,9 +14,9 @@
 
 
 
-int main()
+int main( int argc, char ** argv )
 {
-	BCForth::Run();
+	BCForth::Run( BCForth::ParseRunOptions( argc, argv ) );
 }
 
 
@@ -0,0 +1,11 @@
+# Checks that the cache directory DIR holds NUM compiled files
+#
+# cmake -DDIR=path -DNUM=n -P CountCacheFiles.cmake
+
+
+file( GLOB cached "${DIR}/*.fbc" )
+list( LENGTH cached num_cached )
+
+if( NOT num_cached EQUAL NUM )
+	message( FATAL_ERROR "${DIR} holds ${num_cached} cached files rather than ${NUM}: ${cached}" )
+endif()
@@ -0,0 +1,42 @@
+# Runs BCFORTH with the SCRIPT on its input (and the options in ARGS), then compares
+# what it prints with the EXPECTED file. The banner, the prompts and the timings are left out.
+#
+# cmake -DBCFORTH=path -DSCRIPT=path -DEXPECTED=path [ -DARGS=opt;opt ] -P RunForthScript.cmake
+
+
+execute_process( COMMAND ${BCFORTH} ${ARGS}
+				INPUT_FILE ${SCRIPT}
+				OUTPUT_VARIABLE out
+				ERROR_VARIABLE out
+				RESULT_VARIABLE result
+				TIMEOUT 60 )
+
+if( NOT result EQUAL 0 )
+	message( FATAL_ERROR "${BCFORTH} ended with ${result}:\n${out}" )
+endif()
+
+
+function( normalize text out_var )
+	string( REPLACE "\r" "" text "${text}" )
+	# A line is taken out with its end, so the one after it is only seen in the next pass
+	foreach( pattern "OK:" "=+" "Welcome to the Forth[^\n]*" "Written by[^\n]*" "Bye, bye[^\n]*" "[^\n]* loaded in [^\n]*" )
+		set( prev "" )
+		while( NOT prev STREQUAL text )
+			set( prev "${text}" )
+			string( REGEX REPLACE "(^|\n)${pattern}(\n|$)" "\\1" text "${text}" )
+		endwhile()
+	endforeach()
+	string( REGEX REPLACE "\n\n+" "\n" text "${text}" )
+	string( STRIP "${text}" text )
+	set( ${out_var} "${text}" PARENT_SCOPE )
+endfunction()
+
+
+file( READ ${EXPECTED} expected )
+
+normalize( "${out}" actual )
+normalize( "${expected}" expected )
+
+if( NOT actual STREQUAL expected )
+	message( FATAL_ERROR "${SCRIPT}\n--- expected:\n${expected}\n--- got:\n${actual}" )
+endif()
@@ -0,0 +1,54 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+
+// Two Forths in one program - the nodes of each go to its own arena, whichever of them
+// was made last, so a Forth can be destroyed before or after the other one.
+
+
+
+#include "Interfaces.h"
+
+
+
+
+int main()
+{
+	using namespace BCForth;
+
+	try
+	{
+		auto a { std::make_unique< TForthCompiler >() };
+		auto b { std::make_unique< TForthCompiler >() };
+
+		const auto b_allocs { b->GetNodeArena().GetNumOfAllocs() };
+		LoadNativeModules( * a );			// while b is the latest Forth
+		if( a->GetNodeArena().GetNumOfAllocs() == 0 || b->GetNodeArena().GetNumOfAllocs() != b_allocs )
+		{
+			std::cerr << "Error: the nodes of a Forth went to the arena of the other one" << std::endl;
+			return 1;
+		}
+
+		LoadNativeModules( * b );
+		b.reset();							// the later one goes first
+
+		auto c { std::make_unique< TForthCompiler >() };
+		LoadNativeModules( * c );
+		a.reset();
+		c.reset();
+	}
+	catch( const std::exception & e )
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,69 @@
+// ========================================================================
+//
+// The Forth interpreter-compiler by Prof. Boguslaw Cyganek (C) 2021
+//
+// The software is supplied as is and for educational purposes
+// without any guarantees nor responsibility of its use in any application.
+//
+// ========================================================================
+
+
+
+// Run at build time - compiles the words defined in Forth (CoreDefinedWords, AuxTextModule
+// and AddOns.txt) and writes their image as a C++ array, which goes into the BCForth program.
+//
+// Usage: MakeBuiltinImage <path to AddOns.txt> <output header>
+
+
+
+#include "Interfaces.h"
+
+
+
+
+int main( int argc, char ** argv )
+{
+	using namespace BCForth;
+
+	if( argc != 3 )
+	{
+		std::cerr << "Usage: MakeBuiltinImage <add-ons file> <output header>" << std::endl;
+		return 1;
+	}
+
+	if( ! fs::exists( argv[ 1 ] ) )
+	{
+		std::cerr << "Error: cannot find " << argv[ 1 ] << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		TForthCompiler	F_compiler;
+
+		LoadNativeModules( F_compiler );
+		LoadTextModules( F_compiler, argv[ 1 ] );
+
+		const auto bytes { TForthImageFor< TForthCompiler >( F_compiler ).Make() };
+
+		std::ofstream file( argv[ 2 ] );
+		file << "// Generated by MakeBuiltinImage - do not edit\n\n#pragma once\n\n\nnamespace BCForth\n{\n\n";
+		file << "\tinline constexpr RawByte kBuiltinImage[] {";
+		for( std::size_t i {}; i < bytes.size(); ++ i )
+			file << ( i % 16 == 0 ? "\n\t\t" : " " ) << static_cast< unsigned >( bytes[ i ] ) << ',';
+		file << "\n\t};\n\n}\n";
+
+		if( ! file )
+		{
+			std::cerr << "Error: cannot write " << argv[ 2 ] << std::endl;
+			return 1;
+		}
+	}
+	catch( const ForthError & err )
+	{
+		std::cerr << "Error: " << err.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}